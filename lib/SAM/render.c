@@ -354,8 +354,28 @@ pos48315:
 
 
 
-//void Code47574()
+// Render() is split into RenderBegin(), which builds the frame tables,
+// and RenderStep(), which runs a bounded number of iterations of the
+// sound output loop. The loop variables are kept here in between.
+static struct
+{
+    unsigned char phase1;
+    unsigned char phase2;
+    unsigned char phase3;
+    unsigned char mem66;
+    unsigned char mem38;
+    unsigned char speedcounter;
+    unsigned char mem48;
+} renderState;
+
 void Render()
+{
+    if (!RenderBegin()) return;
+    while (RenderStep(0x7fffffff));
+}
+
+//void Code47574()
+int RenderBegin()
 {
     unsigned char phase1 = 0;  //mem43
     unsigned char phase2=0;
@@ -366,7 +386,7 @@ void Render()
     unsigned char speedcounter=0; //mem45
     unsigned char mem48=0;
     int i;
-    if (phonemeIndexOutput[0] == 255) return; //exit if no data
+    if (phonemeIndexOutput[0] == 255) return 0; //exit if no data
 
     A = 0;
     X = 0;
@@ -791,9 +811,31 @@ if (debug)
 // To simulate them being driven by the glottal pulse, the waveforms are
 // reset at the beginning of each glottal pulse.
 
+    renderState.phase1 = phase1;
+    renderState.phase2 = phase2;
+    renderState.phase3 = phase3;
+    renderState.mem66 = mem66;
+    renderState.mem38 = mem38;
+    renderState.speedcounter = speedcounter;
+    renderState.mem48 = mem48;
+    return 1;
+}
+
+// Runs at most budget iterations of the output loop, returns 0 once the
+// phrase segment is rendered completely.
+int RenderStep(int budget)
+{
+    unsigned char phase1 = renderState.phase1;
+    unsigned char phase2 = renderState.phase2;
+    unsigned char phase3 = renderState.phase3;
+    unsigned char mem66 = renderState.mem66;
+    unsigned char mem38 = renderState.mem38;
+    unsigned char speedcounter = renderState.speedcounter;
+    unsigned char mem48 = renderState.mem48;
+
     //finally the loop for sound output
     //pos48078:
-    while(1)
+    while(budget-- > 0)
     {
         // get the sampled information on the phoneme
         A = sampledConsonantFlag[Y];
@@ -843,7 +885,7 @@ if (debug)
         }
 
         // if the frame count is zero, exit the loop
-        if(mem48 == 0)  return;
+        if(mem48 == 0)  return 0;
         speedcounter = speed;
 pos48155:
 
@@ -888,6 +930,15 @@ pos48159:
         goto pos48159;
     } //while
 
+    renderState.phase1 = phase1;
+    renderState.phase2 = phase2;
+    renderState.phase3 = phase3;
+    renderState.mem66 = mem66;
+    renderState.mem38 = mem38;
+    renderState.speedcounter = speedcounter;
+    renderState.mem48 = mem48;
+    return 1;
+
 
     // The following code is never reached. It's left over from when
     // the voiced sample code was part of this loop, instead of part
@@ -938,7 +989,7 @@ pos48159:
     mem44 = 1;
     mem66 = Y;
     Y = mem49;
-    return;
+    return 0;
 }
 
 
@@ -2,6 +2,8 @@
 #define RENDER_H
 
 void Render();
+int RenderBegin();
+int RenderStep(int budget);
 void SetMouthThroat(unsigned char mouth, unsigned char throat);
 
 #endif
@@ -29,6 +29,11 @@ unsigned char mem59=0;
 
 unsigned char A, X, Y;
 
+// PrepareOutput() progress for SAMRenderStep()
+unsigned char prepareX = 0;
+int prepareDone = 1;
+int rendering = 0;
+
 unsigned char stress[256]; //numbers from 0 to 8
 unsigned char phonemeLength[256]; //tab40160
 unsigned char phonemeindex[256];
@@ -67,6 +72,9 @@ void Init();
 int Parser1();
 void Parser2();
 int SAMMain();
+int SAMPrepare();
+int SAMRenderStep(int budget);
+int NextSegment();
 void CopyStress();
 void SetPhonemeLength();
 void AdjustLengths();
@@ -147,6 +155,17 @@ void Init()
 
 //int Code39771()
 int SAMMain()
+{
+    if (!SAMPrepare()) return 0;
+
+    PrepareOutput();
+
+    return 1;
+}
+
+// Runs everything up to the sound output, which is then produced by
+// SAMRenderStep() in pieces.
+int SAMPrepare()
 {
     Init();
     phonemeindex[255] = 32; //to prevent buffer overflow
@@ -179,17 +198,43 @@ int SAMMain()
         PrintPhonemes(phonemeindex, phonemeLength, stress);
     }
 
-    PrepareOutput();
+    prepareX = 0;
+    prepareDone = 0;
+    rendering = 0;
 
     return 1;
 }
 
+// Renders at most budget iterations of the output loop (roughly 4 samples
+// each), returns 0 when the whole phrase is rendered.
+int SAMRenderStep(int budget)
+{
+    if (!rendering)
+    {
+        if (!NextSegment()) return 0;
+        rendering = RenderBegin();
+        if (!rendering) return 1;
+    }
+
+    rendering = RenderStep(budget);
+    return 1;
+}
 
 //void Code48547()
 void PrepareOutput()
 {
+    while (NextSegment())
+        Render();
+}
+
+// Copies the next phoneme segment (up to a 254 break or the 255 end mark)
+// into the output tables, returns 0 if there is none left.
+int NextSegment()
+{
+    if (prepareDone) return 0;
+
     A = 0;
-    X = 0;
+    X = prepareX;
     Y = 0;
 
     //pos48551:
@@ -200,20 +245,16 @@ void PrepareOutput()
         {
             A = 255;
             phonemeIndexOutput[Y] = 255;
-            Render();
-            return;
+            prepareDone = 1;
+            return 1;
         }
         if (A == 254)
         {
             X++;
-            int temp = X;
             //mem[48546] = X;
+            prepareX = X;
             phonemeIndexOutput[Y] = 255;
-            Render();
-            //X = mem[48546];
-            X=temp;
-            Y = 0;
-            continue;
+            return 1;
         }
 
         if (A == 0)
@@ -10,6 +10,8 @@ void EnableSingmode();
 void EnableDebug();
 
 int SAMMain();
+int SAMPrepare();
+int SAMRenderStep(int budget);
 extern void (*SAM_write_buffer)(int pos, char value); //Overwrite for own buffer
 
 char* GetBuffer();
@@ -33,25 +33,50 @@ namespace plaits {
 using namespace std;
 using namespace stmlib;
 
+const PostProcessingSettings kEnginePostProcessingSettings[kMaxEngines] = {
+  { 0.8f, 0.8f, false },  // virtual analog
+  { 0.7f, 0.6f, false },  // waveshaping
+  { 0.6f, 0.6f, false },  // fm
+  { 0.7f, 0.6f, false },  // grain
+  { 0.8f, 0.8f, false },  // additive
+  { 0.6f, 0.6f, false },  // wavetable
+  { 0.8f, 0.8f, false },  // chord
+  { -0.7f, 0.8f, false },  // speech
+  { -3.0f, 1.0f, false },  // swarm
+  { -1.0f, -1.0f, false },  // noise
+  { -2.0f, 1.0f, false },  // particle
+  { -1.0f, 0.8f, true },  // string
+  { -0.5f, 0.8f, true },  // modal
+  { 0.8f, 0.8f, true },  // bass drum
+  { 0.8f, 0.8f, true },  // snare drum
+  { 0.8f, 0.8f, true },  // hi-hat
+};
+
 void Voice::Init(BufferAllocator* allocator) {
+  Engine* engines[kMaxEngines] = {
+    &virtual_analog_engine_,
+    &waveshaping_engine_,
+    &fm_engine_,
+    &grain_engine_,
+    &additive_engine_,
+    &wavetable_engine_,
+    &chord_engine_,
+    &speech_engine_,
+    &swarm_engine_,
+    &noise_engine_,
+    &particle_engine_,
+    &string_engine_,
+    &modal_engine_,
+    &bass_drum_engine_,
+    &snare_drum_engine_,
+    &hi_hat_engine_,
+  };
+
   engines_.Init();
-  engines_.RegisterInstance(&virtual_analog_engine_, false, 0.8f, 0.8f);
-  engines_.RegisterInstance(&waveshaping_engine_, false, 0.7f, 0.6f);
-  engines_.RegisterInstance(&fm_engine_, false, 0.6f, 0.6f);
-  engines_.RegisterInstance(&grain_engine_, false, 0.7f, 0.6f);
-  engines_.RegisterInstance(&additive_engine_, false, 0.8f, 0.8f);
-  engines_.RegisterInstance(&wavetable_engine_, false, 0.6f, 0.6f);
-  engines_.RegisterInstance(&chord_engine_, false, 0.8f, 0.8f);
-  engines_.RegisterInstance(&speech_engine_, false, -0.7f, 0.8f);
-
-  engines_.RegisterInstance(&swarm_engine_, false, -3.0f, 1.0f);
-  engines_.RegisterInstance(&noise_engine_, false, -1.0f, -1.0f);
-  engines_.RegisterInstance(&particle_engine_, false, -2.0f, 1.0f);
-  engines_.RegisterInstance(&string_engine_, true, -1.0f, 0.8f);
-  engines_.RegisterInstance(&modal_engine_, true, -0.5f, 0.8f);
-  engines_.RegisterInstance(&bass_drum_engine_, true, 0.8f, 0.8f);
-  engines_.RegisterInstance(&snare_drum_engine_, true, 0.8f, 0.8f);
-  engines_.RegisterInstance(&hi_hat_engine_, true, 0.8f, 0.8f);
+  for (int i = 0; i < kMaxEngines; ++i) {
+    const PostProcessingSettings& s = kEnginePostProcessingSettings[i];
+    engines_.RegisterInstance(engines[i], s.already_enveloped, s.out_gain, s.aux_gain);
+  }
   for (int i = 0; i < engines_.size(); ++i) {
     // All engines will share the same RAM space.
     allocator->Free();
@@ -63,6 +63,9 @@ const int kMaxEngines = 16;
 const int kMaxTriggerDelay = 8;
 const int kTriggerDelay = 5;
 
+// Post-processing settings (out gain, aux gain, already enveloped) by engine index.
+extern const PostProcessingSettings kEnginePostProcessingSettings[kMaxEngines];
+
 struct Frame {
   float* out;
   float* aux;
@@ -196,9 +199,11 @@ class Voice {
   inline int active_engine() const { return previous_engine_index_; }
     
  private:
+  template<int> friend class SingleEngineVoice;
+
   void ComputeDecayParameters(const Patch& settings);
   
-  inline float ApplyModulations(
+  static inline float ApplyModulations(
       float base_value,
       float modulation_amount,
       bool use_external_modulation,
@@ -262,6 +267,267 @@ class Voice {
   DISALLOW_COPY_AND_ASSIGN(Voice);
 };
 
+// Engine class and RAM requirement (bytes allocated in Init()) by engine index.
+// BufferAllocator::Allocate() asserts that the allocations fit - the host tests
+// construct every engine.
+template<int engine> struct EngineTraits { };
+
+template<> struct EngineTraits<0> { typedef VirtualAnalogEngine Type; enum { kBufferSize = 96 }; };
+template<> struct EngineTraits<1> { typedef WaveshapingEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<2> { typedef FMEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<3> { typedef GrainEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<4> { typedef AdditiveEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<5> { typedef WavetableEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<6> { typedef ChordEngine Type; enum { kBufferSize = 272 }; };
+template<> struct EngineTraits<7> { typedef SpeechEngine Type; enum { kBufferSize = 16384 }; };
+template<> struct EngineTraits<8> { typedef SwarmEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<9> { typedef NoiseEngine Type; enum { kBufferSize = 96 }; };
+template<> struct EngineTraits<10> { typedef ParticleEngine Type; enum { kBufferSize = 16384 }; };
+template<> struct EngineTraits<11> { typedef StringEngine Type; enum { kBufferSize = 15520 }; };
+template<> struct EngineTraits<12> { typedef ModalEngine Type; enum { kBufferSize = 96 }; };
+template<> struct EngineTraits<13> { typedef BassDrumEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<14> { typedef SnareDrumEngine Type; enum { kBufferSize = 0 }; };
+template<> struct EngineTraits<15> { typedef HiHatEngine Type; enum { kBufferSize = 192 }; };
+
+// Same signal path as Voice, for a single engine selected at compile time -
+// without the other 15 engines, the engine registry and the shared 16kB arena.
+template<int engine>
+class SingleEngineVoice {
+ public:
+  typedef typename EngineTraits<engine>::Type EngineType;
+
+  SingleEngineVoice() { }
+  ~SingleEngineVoice() { }
+
+  void Init() {
+    stmlib::BufferAllocator allocator(buffer_, sizeof(buffer_));
+    engine_.Init(&allocator);
+    engine_.post_processing_settings = kEnginePostProcessingSettings[engine];
+    reset_ = true;
+
+    out_post_processor_.Init();
+    aux_post_processor_.Init();
+
+    decay_envelope_.Init();
+    lpg_envelope_.Init();
+
+    trigger_state_ = false;
+    previous_note_ = 0.0f;
+
+    trigger_delay_.Init(trigger_delay_line_);
+  }
+
+  // note_modulation - optional per sample note offsets (audio rate FM). The
+  // engine is then rendered in sub-blocks of modulation_block_size samples,
+  // with the average offset of each sub-block. Trigger, envelopes and LPG are
+  // still processed once per call.
+  void Render(
+      const Patch& patch,
+      const Modulations& modulations,
+      Frame& frame,
+      const float* note_modulation = NULL,
+      size_t modulation_block_size = kMaxBlockSize) {
+    trigger_delay_.Write(modulations.trigger);
+    float trigger_value = trigger_delay_.Read(kTriggerDelay);
+
+    bool previous_trigger_state = trigger_state_;
+    if (!previous_trigger_state) {
+      if (trigger_value > 0.3f) {
+        trigger_state_ = true;
+        if (!modulations.level_patched) {
+          lpg_envelope_.Trigger();
+        }
+        decay_envelope_.Trigger();
+      }
+    } else {
+      if (trigger_value < 0.1f) {
+        trigger_state_ = false;
+      }
+    }
+
+    if (reset_) {
+      engine_.Reset();
+      out_post_processor_.Reset();
+      reset_ = false;
+    }
+    EngineParameters p;
+
+    bool rising_edge = trigger_state_ && !previous_trigger_state;
+    float note = (modulations.note + previous_note_) * 0.5f;
+    previous_note_ = modulations.note;
+    const PostProcessingSettings& pp_s = engine_.post_processing_settings;
+
+    if (modulations.trigger_patched) {
+      p.trigger = rising_edge ? TRIGGER_RISING_EDGE : TRIGGER_LOW;
+    } else {
+      p.trigger = TRIGGER_UNPATCHED;
+    }
+
+    const float short_decay = (200.0f * kBlockSize) / kSampleRate *
+        stmlib::SemitonesToRatio(-96.0f * patch.decay);
+
+    decay_envelope_.Process(short_decay * 2.0f);
+
+    const float compressed_level = std::max(
+        1.3f * modulations.level / (0.3f + fabsf(modulations.level)),
+        0.0f);
+    p.accent = modulations.level_patched ? compressed_level : 0.8f;
+
+    bool use_internal_envelope = modulations.trigger_patched;
+
+    p.harmonics = patch.harmonics + modulations.harmonics;
+    CONSTRAIN(p.harmonics, 0.0f, 1.0f);
+
+    float internal_envelope_amplitude = 1.0f;
+    if (engine == 7) {
+      internal_envelope_amplitude = 2.0f - p.harmonics * 6.0f;
+      CONSTRAIN(internal_envelope_amplitude, 0.0f, 1.0f);
+      SetProsody(
+          &engine_,
+          !modulations.trigger_patched || modulations.frequency_patched ?
+              0.0f : patch.frequency_modulation_amount,
+          !modulations.trigger_patched || modulations.morph_patched ?
+              0.0f : patch.morph_modulation_amount);
+    }
+
+    p.note = Voice::ApplyModulations(
+        patch.note + note,
+        patch.frequency_modulation_amount,
+        modulations.frequency_patched,
+        modulations.frequency,
+        use_internal_envelope,
+        internal_envelope_amplitude * \
+            decay_envelope_.value() * decay_envelope_.value() * 48.0f,
+        1.0f,
+        -119.0f,
+        120.0f);
+
+    p.timbre = Voice::ApplyModulations(
+        patch.timbre,
+        patch.timbre_modulation_amount,
+        modulations.timbre_patched,
+        modulations.timbre,
+        use_internal_envelope,
+        decay_envelope_.value(),
+        0.0f,
+        0.0f,
+        1.0f);
+
+    p.morph = Voice::ApplyModulations(
+        patch.morph,
+        patch.morph_modulation_amount,
+        modulations.morph_patched,
+        modulations.morph,
+        use_internal_envelope,
+        internal_envelope_amplitude * decay_envelope_.value(),
+        0.0f,
+        0.0f,
+        1.0f);
+
+    bool already_enveloped = pp_s.already_enveloped;
+
+    if (note_modulation) {
+      const float note = p.note;
+      for (size_t i = 0; i < frame.size; i += modulation_block_size) {
+        size_t size = std::min(modulation_block_size, frame.size - i);
+        float offset = 0.0f;
+        for (size_t j = 0; j < size; ++j) {
+          offset += note_modulation[i + j];
+        }
+        p.note = note + offset / static_cast<float>(size);
+        CONSTRAIN(p.note, -119.0f, 120.0f);
+        engine_.Render(p,
+          frame.out ? out_buffer_ + i : nullptr,
+          frame.aux ? aux_buffer_ + i : nullptr,
+          size,
+          &already_enveloped);
+        if (p.trigger == TRIGGER_RISING_EDGE) {
+          p.trigger = TRIGGER_LOW;
+        }
+      }
+      p.note = note;
+    } else {
+      engine_.Render(p,
+        frame.out ? out_buffer_ : nullptr,
+        frame.aux ? aux_buffer_ : nullptr,
+        frame.size,
+        &already_enveloped);
+    }
+
+    bool lpg_bypass = already_enveloped || \
+        (!modulations.level_patched && !modulations.trigger_patched);
+
+    if (!lpg_bypass) {
+      const float hf = patch.lpg_colour;
+      const float decay_tail = (20.0f * kBlockSize) / kSampleRate *
+          stmlib::SemitonesToRatio(-72.0f * patch.decay + 12.0f * hf) - short_decay;
+
+      if (modulations.level_patched) {
+        lpg_envelope_.ProcessLP(compressed_level, short_decay, decay_tail, hf);
+      } else {
+        const float attack = NoteToFrequency(p.note) * float(kBlockSize) * 2.0f;
+        lpg_envelope_.ProcessPing(attack, short_decay, decay_tail, hf);
+      }
+    }
+
+    if (frame.out)
+      out_post_processor_.Process(
+          pp_s.out_gain,
+          lpg_bypass,
+          lpg_envelope_.gain(),
+          lpg_envelope_.frequency(),
+          lpg_envelope_.hf_bleed(),
+          out_buffer_,
+          frame.out,
+          frame.size,
+          1);
+
+    if (frame.aux)
+      aux_post_processor_.Process(
+          pp_s.aux_gain,
+          lpg_bypass,
+          lpg_envelope_.gain(),
+          lpg_envelope_.frequency(),
+          lpg_envelope_.hf_bleed(),
+          aux_buffer_,
+          frame.aux,
+          frame.size,
+          1);
+  }
+
+ private:
+  static inline void SetProsody(SpeechEngine* e, float prosody, float speed) {
+    e->set_prosody_amount(prosody);
+    e->set_speed(speed);
+  }
+
+  template<typename T>
+  static inline void SetProsody(T* e, float prosody, float speed) { }
+
+  EngineType engine_;
+  bool reset_;
+
+  float previous_note_;
+  bool trigger_state_;
+
+  DecayEnvelope decay_envelope_;
+  LPGEnvelope lpg_envelope_;
+
+  float trigger_delay_line_[kMaxTriggerDelay];
+  DelayLine<float, kMaxTriggerDelay> trigger_delay_;
+
+  ChannelPostProcessor out_post_processor_;
+  ChannelPostProcessor aux_post_processor_;
+
+  float out_buffer_[kMaxBlockSize];
+  float aux_buffer_[kMaxBlockSize];
+
+  // Engine RAM (float aligned, at least one element).
+  float buffer_[(EngineTraits<engine>::kBufferSize + sizeof(float)) / sizeof(float)];
+
+  DISALLOW_COPY_AND_ASSIGN(SingleEngineVoice);
+};
+
 }  // namespace plaits
 
 #endif  // PLAITS_DSP_VOICE_H_
@@ -49,6 +49,8 @@ void Part::Init() {
   active_voice_ = 0;
   
   fill(&note_[0], &note_[kMaxPolyphony], 0.0f);
+  fill(&voice_level_[0], &voice_level_[kMaxPolyphony], 0.0f);
+  num_voices_ = 0;
   
   bypass_ = false;
   polyphony_ = 1;
@@ -123,6 +125,7 @@ void Part::ConfigureResonators() {
   if (active_voice_ >= polyphony_) {
     active_voice_ = 0;
   }
+  fill(&voice_level_[0], &voice_level_[kMaxPolyphony], 0.0f);
   dirty_ = false;
 }
 
@@ -496,7 +499,14 @@ void Part::Process(
   
   fill(&out[0], &out[size], 0.0f);
   fill(&aux[0], &aux[size], 0.0f);
+  num_voices_ = 0;
   for (int32_t voice = 0; voice < polyphony_; ++voice) {
+    // Skip voices that have decayed - only the active voice gets new input.
+    if (voice != active_voice_ && voice_level_[voice] < kVoiceCullLevel) {
+      continue;
+    }
+    ++num_voices_;
+
     // Compute MIDI note value, frequency, and cutoff frequency for excitation
     // filter.
     float cutoff = patch.brightness * (2.0f - patch.brightness);
@@ -528,6 +538,12 @@ void Part::Process(
       RenderStringVoice(
           voice, performance_state, patch, frequency, filter_cutoff, size);
     }
+
+    float level = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+      level = max(level, fabsf(out_buffer_[i]) + fabsf(aux_buffer_[i]));
+    }
+    voice_level_[voice] = level;
     
     if (polyphony_ == 1) {
       // Send the two sets of harmonics / pickups to individual outputs.
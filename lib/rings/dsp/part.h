@@ -64,6 +64,10 @@ enum ResonatorModel {
 const int32_t kMaxPolyphony = 3;
 const int32_t kNumStrings = kMaxPolyphony * 2;
 
+// Voices that receive no input and whose output decayed below this level
+// (about -90 dB) are no longer rendered.
+const float kVoiceCullLevel = 3.0e-5f;
+
 class Part {
  public:
   Part() { }
@@ -83,6 +87,7 @@ class Part {
   inline void set_bypass(bool bypass) { bypass_ = bypass; }
 
   inline int32_t polyphony() const { return polyphony_; }
+  inline int32_t num_rendered_voices() const { return num_voices_; }
   inline void set_polyphony(int32_t polyphony) {
     int32_t old_polyphony = polyphony_;
     polyphony_ = std::min(polyphony, kMaxPolyphony);
@@ -171,6 +176,7 @@ class Part {
   Plucker plucker_[kMaxPolyphony];
 
   float note_[kMaxPolyphony];
+  float voice_level_[kMaxPolyphony];
   NoteFilter note_filter_;
   
   float resonator_input_[kMaxBlockSize];
@@ -31,6 +31,7 @@
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/cosine_oscillator.h"
 #include "stmlib/dsp/parameter_interpolator.h"
+#include "stmlib/dsp/simd.h"
 
 #include "rings/resources.h"
 
@@ -40,9 +41,11 @@ using namespace std;
 using namespace stmlib;
 
 void Resonator::Init() {
-  for (int32_t i = 0; i < kMaxModes; ++i) {
-    f_[i].Init();
-  }
+  fill(&g_[0], &g_[kMaxModes], 0.0f);
+  fill(&r_[0], &r_[kMaxModes], 0.0f);
+  fill(&h_[0], &h_[kMaxModes], 0.0f);
+  fill(&state_1_[0], &state_1_[kMaxModes], 0.0f);
+  fill(&state_2_[0], &state_2_[kMaxModes], 0.0f);
 
   set_frequency(220.0f / kSampleRate);
   set_structure(0.25f);
@@ -78,9 +81,9 @@ int32_t Resonator::ComputeFilters() {
     } else {
       num_modes = i + 1;
     }
-    f_[i].set_f_q<FREQUENCY_FAST>(
-        partial_frequency,
-        1.0f + partial_frequency * q);
+    g_[i] = OnePole::tan<FREQUENCY_FAST>(partial_frequency);
+    r_[i] = 1.0f / (1.0f + partial_frequency * q);
+    h_[i] = 1.0f / (1.0f + r_[i] * g_[i] + g_[i] * g_[i]);
     stretch_factor += stiffness;
     if (stiffness < 0.0f) {
       // Make sure that the partials do not fold back into negative frequencies.
@@ -98,21 +101,64 @@ int32_t Resonator::ComputeFilters() {
   return num_modes;
 }
 
+inline float Resonator::ProcessMode(int32_t i, float in) {
+  // Same as Svf::Process<FILTER_MODE_BAND_PASS>.
+  float hp = (in - r_[i] * state_1_[i] - g_[i] * state_1_[i] - state_2_[i]) *
+      h_[i];
+  float bp = g_[i] * hp + state_1_[i];
+  state_1_[i] = g_[i] * hp + bp;
+  float lp = g_[i] * bp + state_2_[i];
+  state_2_[i] = g_[i] * bp + lp;
+  return bp;
+}
+
 void Resonator::Process(const float* in, float* out, float* aux, size_t size) {
-  int32_t num_modes = ComputeFilters();
+  // Modes are summed in pairs (odd/even harmonics) like the original Svf loop,
+  // so an odd count also runs the next, clamped mode - ComputeFilters() has
+  // set it up, the resolution is even.
+  int32_t num_modes = (ComputeFilters() + 1) & ~1;
+  int32_t num_vector_modes = num_modes & ~3;
+  float amplitude[kMaxModes];
   
   ParameterInterpolator position(&previous_position_, position_, size);
   while (size--) {
     CosineOscillator amplitudes;
     amplitudes.Init<COSINE_OSCILLATOR_APPROXIMATE>(position.Next());
+    amplitudes.Start();
+    for (int32_t i = 0; i < num_modes; ++i) {
+      amplitude[i] = amplitudes.Next();
+    }
     
     float input = *in++ * 0.125f;
-    float odd = 0.0f;
-    float even = 0.0f;
-    amplitudes.Start();
-    for (int32_t i = 0; i < num_modes;) {
-      odd += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
-      even += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
+    float4 input_4(input);
+    float4 sum(0.0f);
+    for (int32_t i = 0; i < num_vector_modes; i += 4) {
+      float4 g = float4::Load(&g_[i]);
+      float4 r = float4::Load(&r_[i]);
+      float4 h = float4::Load(&h_[i]);
+      float4 state_1 = float4::Load(&state_1_[i]);
+      float4 state_2 = float4::Load(&state_2_[i]);
+      float4 hp = (input_4 - r * state_1 - g * state_1 - state_2) * h;
+      float4 bp = g * hp + state_1;
+      state_1 = g * hp + bp;
+      float4 lp = g * bp + state_2;
+      state_2 = g * bp + lp;
+      state_1.Store(&state_1_[i]);
+      state_2.Store(&state_2_[i]);
+      sum = sum + float4::Load(&amplitude[i]) * bp;
+    }
+    
+    // num_vector_modes is a multiple of 4, so lanes 0 and 2 hold modes 0, 2,
+    // 4... (odd harmonics) and lanes 1 and 3 the others.
+    float lanes[4];
+    sum.Store(lanes);
+    float odd = lanes[0] + lanes[2];
+    float even = lanes[1] + lanes[3];
+    for (int32_t i = num_vector_modes; i < num_modes;) {
+      odd += amplitude[i] * ProcessMode(i, input);
+      ++i;
+      even += amplitude[i] * ProcessMode(i, input);
+      ++i;
     }
     *out++ = odd;
     *aux++ = even;
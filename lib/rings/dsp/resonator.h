@@ -80,6 +80,7 @@ class Resonator {
   
  private:
   int32_t ComputeFilters();
+  inline float ProcessMode(int32_t i, float in);
   float frequency_;
   float structure_;
   float brightness_;
@@ -89,7 +90,13 @@ class Resonator {
   
   int32_t resolution_;
   
-  stmlib::Svf f_[kMaxModes];
+  // Bank of band-pass SVFs, stored as a struct of arrays so that Process()
+  // can run four modes per step.
+  float g_[kMaxModes];
+  float r_[kMaxModes];
+  float h_[kMaxModes];
+  float state_1_[kMaxModes];
+  float state_2_[kMaxModes];
   
   DISALLOW_COPY_AND_ASSIGN(Resonator);
 };
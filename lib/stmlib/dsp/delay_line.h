@@ -112,6 +112,131 @@ class DelayLine {
   DISALLOW_COPY_AND_ASSIGN(DelayLine);
 };
 
+// Same as DelayLine, but with an externally allocated buffer and block
+// read/write helpers. Indices are wrapped without a modulo: with a mask for
+// power-of-two sizes, otherwise with one compare and subtract - every index
+// is below 2 * size as long as the delays are below size.
+template<typename T, size_t size>
+class BlockDelayLine {
+ public:
+  BlockDelayLine() { }
+  ~BlockDelayLine() { }
+
+  // silence is the value the line is cleared to, for encoded sample formats.
+  void Init(T* buffer, T silence = T(0)) {
+    line_ = buffer;
+    Reset(silence);
+  }
+
+  void Reset(T silence = T(0)) {
+    std::fill(&line_[0], &line_[size], silence);
+    write_ptr_ = 0;
+  }
+
+  inline void Write(const T sample) {
+    line_[write_ptr_] = sample;
+    write_ptr_ = write_ptr_ == 0 ? size - 1 : write_ptr_ - 1;
+  }
+
+  // Writes a block of samples, in[0] first.
+  inline void Write(const T* in, size_t block_size) {
+    while (block_size--) {
+      Write(*in++);
+    }
+  }
+
+  inline const T Allpass(const T sample, size_t delay, const T coefficient) {
+    T read = line_[Wrap(write_ptr_ + delay)];
+    T write = sample + coefficient * read;
+    Write(write);
+    return -write * coefficient + read;
+  }
+
+  inline const T WriteRead(const T sample, float delay) {
+    Write(sample);
+    return Read(delay);
+  }
+
+  inline const T Read(size_t delay) const {
+    return line_[Wrap(write_ptr_ + delay)];
+  }
+
+  // Reads the samples a per-sample Read(delay) / Write() sequence of
+  // block_size steps would have returned. Only valid for
+  // delay >= block_size, since the block is read before it is written.
+  inline void Read(T* out, size_t delay, size_t block_size) const {
+    size_t read_ptr = write_ptr_ + delay;
+    while (block_size--) {
+      *out++ = line_[Wrap(read_ptr)];
+      --read_ptr;
+    }
+  }
+
+  inline const T Read(float delay) const {
+    MAKE_INTEGRAL_FRACTIONAL(delay)
+    const T a = line_[Wrap(write_ptr_ + delay_integral)];
+    const T b = line_[Wrap(write_ptr_ + delay_integral + 1)];
+    return a + (b - a) * delay_fractional;
+  }
+
+  inline const T ReadHermite(float delay) const {
+    MAKE_INTEGRAL_FRACTIONAL(delay)
+    size_t t = (write_ptr_ + delay_integral);
+    const T xm1 = line_[Wrap(t - 1)];
+    const T x0 = line_[Wrap(t)];
+    const T x1 = line_[Wrap(t + 1)];
+    const T x2 = line_[Wrap(t + 2)];
+    const float c = (x1 - xm1) * 0.5f;
+    const float v = x0 - x1;
+    const float w = c + v;
+    const float a = w + v + (x2 - x0) * 0.5f;
+    const float b_neg = w + a;
+    const float f = delay_fractional;
+    return (((a * f) - b_neg) * f + c) * f + x0;
+  }
+
+  // Block version of ReadHermite() with one delay per sample, converting the
+  // stored samples with decode(). Like the block Read(), the block is read
+  // before it is written, so every delay must be >= block_size + 1.
+  template<typename Decoder>
+  inline void ReadHermite(
+      float* out,
+      const float* delay,
+      size_t block_size,
+      Decoder decode) const {
+    for (size_t i = 0; i < block_size; ++i) {
+      const float d = delay[i];
+      MAKE_INTEGRAL_FRACTIONAL(d)
+      size_t t = (write_ptr_ - i + d_integral);
+      const float xm1 = decode(line_[Wrap(t - 1)]);
+      const float x0 = decode(line_[Wrap(t)]);
+      const float x1 = decode(line_[Wrap(t + 1)]);
+      const float x2 = decode(line_[Wrap(t + 2)]);
+      const float c = (x1 - xm1) * 0.5f;
+      const float v = x0 - x1;
+      const float w = c + v;
+      const float a = w + v + (x2 - x0) * 0.5f;
+      const float b_neg = w + a;
+      const float f = d_fractional;
+      out[i] = (((a * f) - b_neg) * f + c) * f + x0;
+    }
+  }
+
+ private:
+  // index < 2 * size
+  static inline size_t Wrap(size_t index) {
+    if ((size & (size - 1)) == 0) {
+      return index & (size - 1);
+    }
+    return index >= size ? index - size : index;
+  }
+
+  size_t write_ptr_;
+  T* line_;
+
+  DISALLOW_COPY_AND_ASSIGN(BlockDelayLine);
+};
+
 }  // namespace stmlib
 
 #endif  // STMLIB_DSP_DELAY_LINE_H_
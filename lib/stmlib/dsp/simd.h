@@ -0,0 +1,120 @@
+// Copyright 2021 Eduard Heidt.
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// 
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Four-lane float vector for struct-of-arrays DSP code. Maps to NEON or SSE
+// when the target has them and to four plain floats otherwise (Cortex-M7 has
+// no float SIMD, but the four independent lanes still keep its FPU pipeline
+// busy). Define STMLIB_SIMD_SCALAR to force the plain version.
+
+#ifndef STMLIB_DSP_SIMD_H_
+#define STMLIB_DSP_SIMD_H_
+
+#include "stmlib/stmlib.h"
+
+#if defined(STMLIB_SIMD_SCALAR)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STMLIB_SIMD_NEON
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define STMLIB_SIMD_SSE
+#endif
+
+namespace stmlib {
+
+#if defined(STMLIB_SIMD_NEON)
+
+struct float4 {
+  float32x4_t v;
+
+  float4() { }
+  float4(float32x4_t x) : v(x) { }
+  explicit float4(float x) : v(vdupq_n_f32(x)) { }
+
+  static inline float4 Load(const float* p) { return vld1q_f32(p); }
+  inline void Store(float* p) const { vst1q_f32(p, v); }
+};
+
+inline float4 operator+(float4 a, float4 b) { return vaddq_f32(a.v, b.v); }
+inline float4 operator-(float4 a, float4 b) { return vsubq_f32(a.v, b.v); }
+inline float4 operator*(float4 a, float4 b) { return vmulq_f32(a.v, b.v); }
+
+#elif defined(STMLIB_SIMD_SSE)
+
+struct float4 {
+  __m128 v;
+
+  float4() { }
+  float4(__m128 x) : v(x) { }
+  explicit float4(float x) : v(_mm_set1_ps(x)) { }
+
+  static inline float4 Load(const float* p) { return _mm_loadu_ps(p); }
+  inline void Store(float* p) const { _mm_storeu_ps(p, v); }
+};
+
+inline float4 operator+(float4 a, float4 b) { return _mm_add_ps(a.v, b.v); }
+inline float4 operator-(float4 a, float4 b) { return _mm_sub_ps(a.v, b.v); }
+inline float4 operator*(float4 a, float4 b) { return _mm_mul_ps(a.v, b.v); }
+
+#else
+
+struct float4 {
+  float v[4];
+
+  float4() { }
+  explicit float4(float x) { v[0] = v[1] = v[2] = v[3] = x; }
+
+  static inline float4 Load(const float* p) {
+    float4 r;
+    r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+    return r;
+  }
+  inline void Store(float* p) const {
+    p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+  }
+};
+
+#define STMLIB_FLOAT4_OP(op) \
+inline float4 operator op(const float4& a, const float4& b) { \
+  float4 r; \
+  r.v[0] = a.v[0] op b.v[0]; \
+  r.v[1] = a.v[1] op b.v[1]; \
+  r.v[2] = a.v[2] op b.v[2]; \
+  r.v[3] = a.v[3] op b.v[3]; \
+  return r; \
+}
+
+STMLIB_FLOAT4_OP(+)
+STMLIB_FLOAT4_OP(-)
+STMLIB_FLOAT4_OP(*)
+
+#undef STMLIB_FLOAT4_OP
+
+#endif  // STMLIB_SIMD_NEON
+
+}  // namespace stmlib
+
+#endif  // STMLIB_DSP_SIMD_H_
@@ -29,6 +29,8 @@
 #ifndef STMLIB_UTILS_BUFFER_ALLOCATOR_H_
 #define STMLIB_UTILS_BUFFER_ALLOCATOR_H_
 
+#include <cassert>
+
 #include "stmlib/stmlib.h"
 
 namespace stmlib {
@@ -51,6 +53,9 @@ class BufferAllocator {
   template<typename T>
   inline T* Allocate(size_t size) {
     size_t size_bytes = sizeof(T) * size;
+    // The engines do not check for NULL - a buffer that is too small (e.g.
+    // plaits::EngineTraits::kBufferSize) would be written through it.
+    assert(size_bytes <= free_);
     if (size_bytes <= free_) {
       T* start = static_cast<T*>(static_cast<void*>(next_));
       next_ += size_bytes;
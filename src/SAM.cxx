@@ -24,6 +24,8 @@
 //
 
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "machine_arena.hxx"
 #include "stmlib/dsp/dsp.h"
 #include "sample.hxx"
 
@@ -39,41 +41,197 @@ namespace sam
 using namespace sam;
 using namespace machine;
 
+#ifndef SAM_CACHE_SIZE
+#define SAM_CACHE_SIZE (64 * 1024) // bytes of rendered phrases kept across selection changes
+#endif
+
 static uint8_t *s_buffer;
 static int s_maxlen;
 static int s_len;
+static struct SAM *s_owner = nullptr; // the SAM state is global - one phrase is rendered at a time
+
+// LRU cache of rendered phrases, shared by all SAM instances.
+// Entries in use by a voice are pinned and never evicted. The storage is taken
+// by the first insert() and returned when the last SAM instance is freed.
+struct PhraseCache
+{
+    struct Key
+    {
+        uint32_t text_hash;
+        uint8_t speed;
+        uint8_t pitch;
+        uint8_t mouth;
+        uint8_t throat;
+
+        bool operator==(const Key &other) const
+        {
+            return text_hash == other.text_hash && speed == other.speed && pitch == other.pitch &&
+                   mouth == other.mouth && throat == other.throat;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        int offset;
+        int len; // 0 = unused
+        uint32_t last_used;
+        uint8_t refs;
+    };
+
+    static constexpr int kMaxEntries = 16;
+
+    machine_arena::Buffer<uint8_t, SAM_CACHE_SIZE> storage;
+    Entry entries[kMaxEntries] = {};
+    uint32_t tick = 0;
+    int instances = 0;
+
+    static uint32_t hash(const char *text)
+    {
+        uint32_t h = 2166136261u; // FNV-1a
+        while (*text)
+            h = (h ^ (uint8_t)*text++) * 16777619u;
+        return h;
+    }
+
+    const uint8_t *data(const Entry *e) const
+    {
+        return storage.get() + e->offset;
+    }
+
+    Entry *find(const Key &key)
+    {
+        for (auto &e : entries)
+        {
+            if (e.len > 0 && e.key == key)
+            {
+                e.last_used = ++tick;
+                return &e;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Entry *insert(const Key &key, const uint8_t *src, int len)
+    {
+        if (len <= 0 || len > SAM_CACHE_SIZE || storage.acquire() == nullptr)
+            return nullptr;
+
+        while (true)
+        {
+            Entry *slot = nullptr;
+            for (auto &e : entries)
+                if (e.len == 0)
+                    slot = &e;
+
+            int offset = slot ? find_gap(len) : -1;
+
+            if (offset >= 0)
+            {
+                memcpy(storage.get() + offset, src, len);
+                *slot = {key, offset, len, ++tick, 0};
+                return slot;
+            }
+
+            if (!evict())
+                return nullptr;
+        }
+    }
+
+    // Lowest offset where len bytes fit between the used entries, or -1.
+    int find_gap(int len) const
+    {
+        int offset = 0;
+
+        while (offset + len <= SAM_CACHE_SIZE)
+        {
+            int next = offset;
+
+            for (auto &e : entries)
+                if (e.len > 0 && e.offset < offset + len && offset < e.offset + e.len)
+                    next = std::max(next, e.offset + e.len);
+
+            if (next == offset)
+                return offset;
+
+            offset = next;
+        }
+
+        return -1;
+    }
+
+    // Drops the least recently used unpinned entry.
+    bool evict()
+    {
+        Entry *lru = nullptr;
+
+        for (auto &e : entries)
+            if (e.len > 0 && e.refs == 0 && (lru == nullptr || e.last_used < lru->last_used))
+                lru = &e;
+
+        if (lru == nullptr)
+            return false;
+
+        lru->len = 0;
+        return true;
+    }
+
+    void clear()
+    {
+        for (auto &e : entries)
+            e = {};
+
+        storage.release();
+    }
+};
+
+static PhraseCache s_cache;
 
 struct SAM : public SampleEngine
 {
-    uint8_t _buffer[48000];
+    static constexpr int kRenderBudget = 64; // output loop iterations per block (~250 samples)
+
+    machine_arena::Buffer<uint8_t, 48000> _buffer; // render target, held from a cache miss until the phrase is cached
     tsample_spec<uint8_t> _sounds[6] = {
-        {">electro", _buffer, 0, 22050, 0},
-        {">techno", _buffer, 0, 22050, 0},
-        {">modular", _buffer, 0, 22050, 0},
-        {">synthesizer", _buffer, 0, 22050, 0},
-        {">oscillator", _buffer, 0, 22050, 0},
-        {">eurorack", _buffer, 0, 22050, 0},
+        {">electro", nullptr, 0, 22050, 0},
+        {">techno", nullptr, 0, 22050, 0},
+        {">modular", nullptr, 0, 22050, 0},
+        {">synthesizer", nullptr, 0, 22050, 0},
+        {">oscillator", nullptr, 0, 22050, 0},
+        {">eurorack", nullptr, 0, 22050, 0},
     };
 
-    int say(const char *text)
+    uint8_t speed = 64;
+    uint8_t pitch = 64 * 2;
+    uint8_t mouth = 128;
+    uint8_t throat = 128;
+
+    PhraseCache::Key key(const char *text) const
+    {
+        return {PhraseCache::hash(text), speed, pitch, mouth, throat};
+    }
+
+    int prepare(const char *text)
     {
         SAM_write_buffer = [](int pos, char value)
         {
             if (pos < s_maxlen)
             {
-                s_len = pos + 1;
+                s_len = std::max(s_len, pos + 1);
                 s_buffer[pos] = value;
             }
         };
 
         s_len = 0;
-        s_maxlen = sizeof(_buffer);
-        s_buffer = _buffer;
+        s_maxlen = _buffer.size();
+        s_buffer = _buffer.get();
+        memset(s_buffer, 0, s_maxlen); // SAM skips positions, the heap isn't zeroed
 
-        SetSpeed(64);
-        SetMouth(128);
-        SetPitch(64 * 2);
-        SetThroat(128);
+        SetSpeed(speed);
+        SetMouth(mouth);
+        SetPitch(pitch);
+        SetThroat(throat);
 
         char input[256] = {};
         sprintf(input, "%s ", text);
@@ -83,33 +241,130 @@ struct SAM : public SampleEngine
         strncat(input, "[", 255);
         TextToPhonemes((unsigned char *)input);
         SetInput(input);
-        SAMMain();
-        return s_len;
+        return SAMPrepare();
     }
 
     int _lastSelection = 0;
+    bool _pending = true;
+    PhraseCache::Entry *_cached = nullptr; // pinned cache entry that is played
+
+    void play(tsample_spec<uint8_t> &smpl, PhraseCache::Entry *e)
+    {
+        e->refs++;
+        _cached = e;
+        smpl.data = s_cache.data(e);
+        smpl.len = e->len;
+    }
+
+    void release()
+    {
+        if (_cached != nullptr)
+            _cached->refs--;
+
+        _cached = nullptr;
+    }
 
 public:
     SAM() : SampleEngine(&_sounds[0], 0, LEN_OF(_sounds))
     {
-        _sounds[0].len = say(&_sounds[0].name[1]);
+        s_cache.instances++;
+    }
+
+    ~SAM()
+    {
+        release();
+
+        if (s_owner == this)
+            s_owner = nullptr;
+
+        if (--s_cache.instances == 0)
+            s_cache.clear();
     }
 
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
         if (_lastSelection != selection)
         {
-            _sounds[selection].len = say(&_sounds[selection].name[1]);
             _lastSelection = selection;
+            _pending = true;
+            release();
+            _sounds[selection].len = 0;
+
+            if (s_owner == this)
+                s_owner = nullptr;
+        }
+
+        auto &smpl = _sounds[selection];
+
+        if (_pending)
+        {
+            if (auto e = s_cache.find(key(&smpl.name[1])))
+            {
+                _pending = false;
+                play(smpl, e);
+                _buffer.release();
+            }
+            else if (s_owner == nullptr && _buffer.acquire() != nullptr)
+            {
+                _pending = false;
+                smpl.data = _buffer.get();
+                smpl.len = 0;
+
+                if (prepare(&smpl.name[1]))
+                    s_owner = this;
+            }
+        }
+
+        if (s_owner == this)
+        {
+            bool done = !SAMRenderStep(kRenderBudget);
+
+            // keep the playback position while the phrase grows
+            if (smpl.len > 0 && i >= 0 && i < 1)
+                i = i * smpl.len / s_len;
+
+            smpl.len = s_len;
+
+            if (done)
+            {
+                s_owner = nullptr;
+
+                if (auto e = s_cache.insert(key(&smpl.name[1]), _buffer.get(), s_len))
+                {
+                    play(smpl, e);
+                    _buffer.release();
+                }
+            }
+        }
+
+        if (smpl.len == 0)
+        {
+            if (frame.trigger)
+                i = start;
+
+            std::fill(buffer, buffer + machine::FRAME_BUFFER_SIZE, 0);
+            of.out = buffer;
+            return;
         }
 
         SampleEngine::process(frame, of);
     }
+
+    void onDisplay(uint8_t *buffer) override
+    {
+        if (_pending && _buffer.failed)
+        {
+            gfx::drawString(buffer, 4, 32, "<<<< OUT OF RAM >>>>");
+            return;
+        }
+
+        SampleEngine::onDisplay(buffer);
+    }
 };
 
 void init_sam()
 {
-    machine::add<SAM>("SPEECH", "SAM");
+    machine::add<Metered<SAM>>("SPEECH", "SAM");
 }
 
 MACHINE_INIT(init_sam);
\ No newline at end of file
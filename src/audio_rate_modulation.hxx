@@ -0,0 +1,128 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+#include <algorithm>
+#include <iterator>
+
+// Opt-in audio rate modulation. Parameter::modulate() applies one value per
+// block. An engine that can follow faster modulation subscribes a parameter
+// with an audio_rate::Input. Audio rate modulation sources then add, per sample,
+// what their signal deviates from the block value into the parameter's lane.
+// Engines without a subscription keep getting the block average, and nothing
+// is written for them.
+
+namespace audio_rate
+{
+    constexpr int kMaxLanes = 8;
+
+    // Engines apply the lane in sub-blocks of this size (12kHz).
+    constexpr size_t kSubBlockSize = 4;
+
+    struct Lane
+    {
+        const void *target = nullptr; // Parameter::value
+        uint32_t t = UINT32_MAX;      // block of the last write
+        float samples[machine::FRAME_BUFFER_SIZE];
+    };
+
+    inline Lane *lanes()
+    {
+        static Lane l[kMaxLanes];
+        return l;
+    }
+
+    inline Lane *find(const void *target)
+    {
+        for (int i = 0; i < kMaxLanes; i++)
+            if (lanes()[i].target == target)
+                return &lanes()[i];
+
+        return nullptr;
+    }
+
+    // For modulation sources - the lane of target, cleared on the first write
+    // in block t, or nullptr if no engine follows target at audio rate.
+    inline float *write(const void *target, uint32_t t)
+    {
+        if (target == nullptr)
+            return nullptr;
+
+        Lane *lane = find(target);
+        if (lane == nullptr)
+            return nullptr;
+
+        if (lane->t != t)
+        {
+            lane->t = t;
+            std::fill(std::begin(lane->samples), std::end(lane->samples), 0.f);
+        }
+
+        return lane->samples;
+    }
+
+    inline float average(const float *samples, size_t size)
+    {
+        float sum = 0;
+        for (size_t i = 0; i < size; i++)
+            sum += samples[i];
+
+        return sum / size;
+    }
+
+    // Engine side - subscribes the parameter value for its lifetime.
+    struct Input
+    {
+        Lane *lane = nullptr;
+
+        explicit Input(const void *target)
+        {
+            lane = find(nullptr);
+            if (lane != nullptr)
+            {
+                lane->target = target;
+                lane->t = UINT32_MAX;
+            }
+        }
+
+        Input(const Input &) = delete;
+        Input &operator=(const Input &) = delete;
+
+        ~Input()
+        {
+            if (lane != nullptr)
+                lane->target = nullptr;
+        }
+
+        // Deviation from the block value per sample, in the units passed to
+        // Parameter::modulate(), or nullptr if no source wrote in block t.
+        const float *read(uint32_t t) const
+        {
+            return (lane != nullptr && lane->t == t) ? lane->samples : nullptr;
+        }
+    };
+} // namespace audio_rate
@@ -1,6 +1,9 @@
 #include "stmlib/stmlib.h"
 #include "stmlib/dsp/dsp.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "output_conversion.hxx"
+#include "audio_rate_modulation.hxx"
 #include "braids/macro_oscillator.h"
 #include "braids/envelope.h"
 #include "braids/settings.h"
@@ -19,6 +22,7 @@ struct BraidsEngine : public Engine
     uint8_t sync_samples[FRAME_BUFFER_SIZE];
 
     float _pitch;
+    audio_rate::Input _pitch_mod{&_pitch}; // FM
     uint8_t _shape;
     uint16_t _timbre;
     uint16_t _color;
@@ -26,6 +30,7 @@ struct BraidsEngine : public Engine
     uint16_t _decay;
 
     float buffer[FRAME_BUFFER_SIZE];
+    float _gain = 0; // VCA gain of the last block
 
     BraidsEngine() : Engine(TRIGGER_INPUT|VOCT_INPUT)
     {
@@ -80,23 +85,39 @@ struct BraidsEngine : public Engine
         pitch += jitter_source.Render(settings.vco_drift());
         pitch += ad_value * settings.GetValue(SETTING_AD_FM) >> 7;
 
-        CONSTRAIN(pitch, 0, 16383);
-
-        if (settings.vco_flatten())
-            pitch = stmlib::Interpolate88(braids::lut_vco_detune, pitch << 2);
-
         osc.set_parameters(_timbre >> 1, _color >> 1);
 
-        osc.set_pitch(pitch + settings.pitch_transposition());
+        if (const float *fm = _pitch_mod.read(frame.t))
+        {
+            for (size_t i = 0; i < FRAME_BUFFER_SIZE; i += audio_rate::kSubBlockSize)
+            {
+                int32_t offset = audio_rate::average(&fm[i], audio_rate::kSubBlockSize) * 12 * 128;
+                set_pitch(pitch + offset);
+                osc.Render(&sync_samples[i], &audio_samples[i], audio_rate::kSubBlockSize);
+            }
+        }
+        else
+        {
+            set_pitch(pitch);
+            osc.Render(sync_samples, audio_samples, FRAME_BUFFER_SIZE);
+        }
 
-        osc.Render(sync_samples, audio_samples, FRAME_BUFFER_SIZE);
+        uint16_t ad = _decay < UINT16_MAX ? ad_value : 65535;
+        float gain = ad * (output_conversion::kInt16VoltsPerLsb / UINT16_MAX / 4);
 
-        uint16_t gain = _decay < UINT16_MAX ? ad_value : 65535;
+        output_conversion::convert(audio_samples, buffer, FRAME_BUFFER_SIZE, _gain, gain);
+        _gain = gain;
+        of.out = buffer;
+    }
 
-        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
-            audio_samples[i] = audio_samples[i] * gain / UINT16_MAX / 4;
+    void set_pitch(int32_t pitch)
+    {
+        CONSTRAIN(pitch, 0, 16383);
 
-        of.push(audio_samples, LEN_OF(audio_samples));
+        if (settings.vco_flatten())
+            pitch = stmlib::Interpolate88(braids::lut_vco_detune, pitch << 2);
+
+        osc.set_pitch(pitch + settings.pitch_transposition());
     }
 
     void onDisplay(uint8_t *buffer) override
@@ -120,7 +141,7 @@ struct BraidsEngine : public Engine
 
 void init_braids()
 {
-    machine::add<BraidsEngine>(M_OSC, "Waveforms");
+    machine::add<Metered<BraidsEngine>>(M_OSC, "Waveforms");
 }
 
 MACHINE_INIT(init_braids);
\ No newline at end of file
@@ -92,6 +92,6 @@ public:
         for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
             bufferOut[i] = (float)((ch_of.out[i] * _ch_vol * ch_ad) + (oh_of.out[i] * oh_ad));
 
-        of.push(bufferOut, LEN_OF(bufferOut));
+        of.out = bufferOut;
     }
 };
\ No newline at end of file
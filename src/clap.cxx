@@ -28,6 +28,7 @@
 #include "stmlib/dsp/filter.h"
 #include "plaits/dsp/envelope.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
 
 #ifndef TEST
 #include "pgmspace.h"
@@ -249,7 +250,7 @@ public:
 
 void init_clap()
 {
-    machine::add<Clap>(machine::DRUM, "Clap");
+    machine::add<Metered<Clap>>(machine::DRUM, "Clap");
     // machine::add<TR909_CP>(machine::DRUM, "TR909-Clap");
     // machine::add<TR808_CP>(machine::DRUM, "TR808-Clap");
     // machine::add<Clap2>(machine::DEV, "Clap2");
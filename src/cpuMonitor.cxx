@@ -0,0 +1,87 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#include "machine.h"
+#include "cpu_meter.hxx"
+
+using namespace machine;
+
+// Debug machine - shows the block budget watchdog and the load of every meter,
+// and switches the load overlay of the other tracks (Metered<T>::onDisplay).
+struct CpuMonitor : public Engine
+{
+    uint8_t overlay = 0;
+
+    CpuMonitor() : Engine(0)
+    {
+        param[0].init("Overlay", &overlay, overlay, 0, 1);
+        param[0].print_value = [&](char *tmp)
+        {
+            sprintf(tmp, "Overlay: %s", overlay ? "on" : "off");
+        };
+        param[0].value_changed = [&]()
+        {
+            cpu_meter::overlay() = overlay != 0;
+        };
+    }
+
+    ~CpuMonitor()
+    {
+        cpu_meter::overlay() = false;
+    }
+
+    void process(const ControlFrame &frame, OutputFrame &of) override
+    {
+    }
+
+    void onDisplay(uint8_t *buffer) override
+    {
+        gfx::drawEngine(buffer, this);
+
+        char tmp[32];
+        auto &w = cpu_meter::watchdog();
+
+        sprintf(tmp, "block:%3d%%  over:%d", (int)(100.f * w.total / cpu_meter::ticks_per_block()), (int)w.overruns);
+        gfx::drawString(buffer, 2, 12, tmp, 0);
+
+        for (int x = 0; x < 128; x += 3)
+            gfx::drawPixel(buffer, x, 18);
+
+        // load / peak of every metered engine and modulation, two columns
+        int i = 0;
+        for (auto m = cpu_meter::first(); m != nullptr && i < 12; m = m->next, i++)
+        {
+            sprintf(tmp, "%s%3d/%3d%%", m == w.culprit ? "!" : " ", (int)(m->load() * 100), (int)(m->peak_load() * 100));
+            gfx::drawString(buffer, (i / 6) * 64 + 2, 20 + (i % 6) * 6, tmp, 0);
+        }
+    }
+};
+
+void init_cpu_monitor()
+{
+    machine::add<Metered<CpuMonitor>>("MIDI", "CPU");
+}
+
+MACHINE_INIT(init_cpu_monitor);
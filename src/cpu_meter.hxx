@@ -0,0 +1,250 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+#include <utility>
+
+#ifndef TEST
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// Per engine CPU meter - register engines as machine::add<Metered<T>>(...) and
+// modulation sources as machine::add_modulation_source<MeteredModulation<T>>(...).
+// Time is measured in ticks: CPU cycles on the device, nanoseconds on the host.
+
+namespace cpu_meter
+{
+#ifndef TEST
+    inline uint32_t ticks()
+    {
+        return ARM_DWT_CYCCNT;
+    }
+
+    inline uint32_t ticks_per_block()
+    {
+        return F_CPU_ACTUAL / (machine::SAMPLE_RATE / machine::FRAME_BUFFER_SIZE);
+    }
+#else
+    inline uint32_t ticks()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    }
+
+    inline uint32_t ticks_per_block()
+    {
+        return (uint32_t)(1000000000ull * machine::FRAME_BUFFER_SIZE / machine::SAMPLE_RATE);
+    }
+#endif
+
+    struct Meter;
+
+    // Sum of all meters per block (ControlFrame::t) - an overrun is a block
+    // where the metered code alone took longer than the block period.
+    struct Watchdog
+    {
+        uint32_t t = 0;
+        uint32_t total = 0;
+        uint32_t overruns = 0;
+        const Meter *top = nullptr;    // most expensive meter of the current block
+        const Meter *culprit = nullptr; // most expensive meter of the last overrun block
+    };
+
+    inline Watchdog &watchdog()
+    {
+        static Watchdog w;
+        return w;
+    }
+
+    inline Meter *&first()
+    {
+        static Meter *head = nullptr;
+        return head;
+    }
+
+    // Draws the load of the displayed engine in the top right corner.
+    inline bool &overlay()
+    {
+        static bool enabled = false;
+        return enabled;
+    }
+
+    struct Meter
+    {
+        const void *owner; // the metered engine or modulation source
+        Meter *next = nullptr;
+
+        float average = 0;     // ticks per block, smoothed over ~64 blocks
+        uint32_t last = 0;     // ticks of the last block
+        uint32_t peak = 0;     // worst case since reset()
+        uint32_t overruns = 0; // blocks exceeding the budget on its own
+
+        explicit Meter(const void *owner) : owner(owner)
+        {
+            next = first();
+            first() = this;
+        }
+
+        ~Meter()
+        {
+            for (Meter **p = &first(); *p != nullptr; p = &(*p)->next)
+            {
+                if (*p == this)
+                {
+                    *p = next;
+                    break;
+                }
+            }
+
+            auto &w = watchdog();
+            if (w.top == this)
+                w.top = nullptr;
+            if (w.culprit == this)
+                w.culprit = nullptr;
+        }
+
+        void update(uint32_t t, uint32_t elapsed)
+        {
+            last = elapsed;
+            average += (elapsed - average) * (1.f / 64);
+
+            if (elapsed > peak)
+                peak = elapsed;
+
+            if (elapsed > ticks_per_block())
+                overruns++;
+
+            auto &w = watchdog();
+
+            if (w.t != t)
+            {
+                if (w.total > ticks_per_block())
+                {
+                    w.overruns++;
+                    w.culprit = w.top;
+                }
+
+                w.t = t;
+                w.total = 0;
+                w.top = nullptr;
+            }
+
+            w.total += elapsed;
+
+            if (w.top == nullptr || elapsed > w.top->last)
+                w.top = this;
+        }
+
+        void reset()
+        {
+            peak = 0;
+            overruns = 0;
+        }
+
+        float load() const
+        {
+            return average / ticks_per_block();
+        }
+
+        float peak_load() const
+        {
+            return (float)peak / ticks_per_block();
+        }
+    };
+
+    inline const Meter *find(const void *owner)
+    {
+        for (auto m = first(); m != nullptr; m = m->next)
+            if (m->owner == owner)
+                return m;
+
+        return nullptr;
+    }
+
+    struct Scope
+    {
+        Meter &meter;
+        uint32_t t;
+        uint32_t start;
+
+        Scope(Meter &meter, uint32_t t) : meter(meter), t(t), start(ticks())
+        {
+        }
+
+        ~Scope()
+        {
+            meter.update(t, ticks() - start);
+        }
+    };
+} // namespace cpu_meter
+
+template <class T>
+struct Metered : public T
+{
+    cpu_meter::Meter meter;
+
+    template <typename... Args>
+    Metered(Args &&...args) : T(std::forward<Args>(args)...), meter(this)
+    {
+    }
+
+    void process(const machine::ControlFrame &frame, machine::OutputFrame &of) override
+    {
+        cpu_meter::Scope scope(meter, frame.t);
+        T::process(frame, of);
+    }
+
+    void onDisplay(uint8_t *buffer) override
+    {
+        T::onDisplay(buffer);
+
+        if (cpu_meter::overlay())
+        {
+            char tmp[16];
+            sprintf(tmp, "%d%%", (int)(meter.load() * 100));
+            gfx::drawString(buffer, 128 - 4 * strlen(tmp), 0, tmp, 0);
+        }
+    }
+};
+
+template <class T>
+struct MeteredModulation : public T
+{
+    cpu_meter::Meter meter;
+
+    MeteredModulation() : T(), meter(this)
+    {
+    }
+
+    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    {
+        cpu_meter::Scope scope(meter, frame.t);
+        T::process(target, frame);
+    }
+};
@@ -0,0 +1,93 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include <math.h>
+
+// Approximations for the transcendental functions in the engine hot paths.
+// Error bounds (measured by test/fast_math.cxx against double precision):
+//
+//   sin, cos    absolute error < 4e-7 for |x| < 1000
+
+namespace fast_math
+{
+    constexpr float kPi = 3.14159265358979f;
+
+    // x - 2 pi round(x / 2 pi) in [-pi, pi], with Cody-Waite reduction.
+    inline float wrap(float x)
+    {
+        constexpr float kOneOverTwoPi = 0.159154943091895f;
+        constexpr float kTwoPiHi = 6.28125f;
+        constexpr float kTwoPiLo = 1.93530717958648e-3f;
+
+        // Round to nearest by adding 1.5 * 2^23 - no float/int round trip, which
+        // stalls on x86. Needs IEEE arithmetic, i.e. no -ffast-math.
+        constexpr float kRound = 12582912.f;
+        float turns = (x * kOneOverTwoPi + kRound) - kRound;
+        return (x - turns * kTwoPiHi) - turns * kTwoPiLo;
+    }
+
+    // sin(r) for r in [-pi/2, pi/2], odd degree 9 polynomial fitted at the
+    // Chebyshev nodes (error 3e-8) - split in two halves to shorten the chain
+    // of dependent multiply-adds.
+    inline float sin_poly(float r)
+    {
+        float r2 = r * r;
+        float r4 = r2 * r2;
+        float lo = -1.666666596e-1f + r2 * 8.333242135e-3f;
+        float hi = -1.982273949e-4f + r2 * 2.634756392e-6f;
+        return r + r * r2 * (lo + r4 * hi);
+    }
+
+    // cos(r) = sin(pi/2 - |r|) and sin(r) = cos(r - pi/2) for r in [-pi, pi].
+    inline float cos_wrapped(float r)
+    {
+        return sin_poly(kPi / 2 - fabsf(r));
+    }
+
+    inline float sin_wrapped(float r)
+    {
+        r -= kPi / 2;
+        return cos_wrapped(r < -kPi ? r + 2 * kPi : r);
+    }
+
+    inline float sin(float x)
+    {
+        return sin_wrapped(wrap(x));
+    }
+
+    inline float cos(float x)
+    {
+        return cos_wrapped(wrap(x));
+    }
+
+    inline void sincos(float x, float *sin, float *cos)
+    {
+        float r = wrap(x);
+        *sin = sin_wrapped(r);
+        *cos = cos_wrapped(r);
+    }
+} // namespace fast_math
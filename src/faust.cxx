@@ -1,4 +1,5 @@
 #include "machine.h"
+#include "cpu_meter.hxx"
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/units.h"
 
@@ -150,8 +151,8 @@ void init_faust()
 {
     //(char[sizeof(mydsp)])"";
 
-    machine::add<FaustEngine<djembe, machine::TRIGGER_INPUT>>(machine::DRUM, "Djembe");
-    machine::add<FaustEngine<rev_dattorro, machine::AUDIO_PROCESSOR>>(machine::FX, "Rev-Dattorro");
+    machine::add<Metered<FaustEngine<djembe, machine::TRIGGER_INPUT>>>(machine::DRUM, "Djembe");
+    machine::add<Metered<FaustEngine<rev_dattorro, machine::AUDIO_PROCESSOR>>>(machine::FX, "Rev-Dattorro");
 }
 
 MACHINE_INIT(init_faust);
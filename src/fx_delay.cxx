@@ -28,6 +28,9 @@
 #include "stmlib/dsp/filter.h"
 #include "stmlib/dsp/delay_line.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "fast_math.hxx"
+#include "machine_arena.hxx"
 #include <vector>
 
 #define clamp(value, min, max)             \
@@ -36,46 +39,137 @@
 
 using namespace machine;
 
+// Storage formats of the delay memory.
+
+struct PCM16
+{
+    typedef uint16_t Sample;
+
+    static inline float Decode(uint16_t sample)
+    {
+        return static_cast<float>(static_cast<int16_t>(sample)) / 32768.0f;
+    }
+
+    static inline uint16_t Encode(float sample)
+    {
+        return static_cast<uint16_t>(stmlib::Clip16(static_cast<int32_t>(sample * 32768.0f)));
+    }
+};
+
+// G.711 mu-law - half the memory, ~13 bit dynamic range, audible as a slight grit on quiet tails.
+struct MuLaw
+{
+    typedef uint8_t Sample;
+
+    static constexpr int32_t kBias = 0x84;
+    static constexpr int32_t kClip = 32635;
+
+    static const float *decode_table()
+    {
+        static float table[256];
+        static bool ready = false;
+
+        if (!ready)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                int32_t u = ~i & 0xff;
+                int32_t exponent = (u >> 4) & 7;
+                int32_t magnitude = ((((u & 0x0f) << 3) + kBias) << exponent) - kBias;
+                table[i] = (u & 0x80 ? -magnitude : magnitude) / 32768.0f;
+            }
+            ready = true;
+        }
+
+        return table;
+    }
+
+    static inline float Decode(uint8_t sample)
+    {
+        static const float *table = decode_table();
+        return table[sample];
+    }
+
+    static inline uint8_t Encode(float sample)
+    {
+        int32_t pcm = stmlib::Clip16(static_cast<int32_t>(sample * 32768.0f));
+        int32_t sign = 0;
+
+        if (pcm < 0)
+        {
+            pcm = -pcm;
+            sign = 0x80;
+        }
+
+        if (pcm > kClip)
+            pcm = kClip;
+
+        pcm += kBias;
+
+        int32_t exponent = (31 - __builtin_clz(pcm)) - 7; // pcm >= kBias, so bit 7 is the lowest leading bit
+        int32_t mantissa = (pcm >> (exponent + 3)) & 0x0f;
+        return ~(sign | (exponent << 4) | mantissa);
+    }
+};
+
+template <class Codec>
 struct Delay : public Engine
 {
+    typedef typename Codec::Sample Sample;
+
     float time = 0.5f;
     float color = 0.5f;
     float level = 0.5f;
     float pan = 0.5f;
+    float mod_depth = 0.f;
+    float mod_rate = 0.5f;
 
     constexpr static int delay_len = 48000; //1s
+    constexpr static float max_mod_depth = 0.005f * machine::SAMPLE_RATE; // 5ms
 
-    stmlib::DelayLine<uint16_t, delay_len> delay_mem[2];
+    machine_arena::Buffer<Sample, delay_len> delay_buffer[2];
+    stmlib::BlockDelayLine<Sample, delay_len> delay_mem[2];
     stmlib::OnePole filterLP[2];
     stmlib::OnePole filterHP[2];
 
-    inline const float DelayRead(stmlib::DelayLine<uint16_t, delay_len> &line_, float delay) const
-    {
-        return static_cast<float>(static_cast<int16_t>(line_.Read(delay))) / 32768.0f;
-    }
-
-    inline void DelayWrite(stmlib::DelayLine<uint16_t, delay_len> &line_, const float sample)
-    {
-        line_.Write(static_cast<uint16_t>(
-            stmlib::Clip16(static_cast<int32_t>(sample * 32768.0f))));
-    }
-
+    float delayL[FRAME_BUFFER_SIZE]; // per sample read positions
+    float delayR[FRAME_BUFFER_SIZE];
+    float tapL[FRAME_BUFFER_SIZE];
+    float tapR[FRAME_BUFFER_SIZE];
+    float filteredL[FRAME_BUFFER_SIZE];
+    float filteredR[FRAME_BUFFER_SIZE];
+    Sample feedL[FRAME_BUFFER_SIZE];
+    Sample feedR[FRAME_BUFFER_SIZE];
     float bufferL[FRAME_BUFFER_SIZE];
     float bufferR[FRAME_BUFFER_SIZE];
 
     Delay() : Engine(AUDIO_PROCESSOR)
     {
-        delay_mem[0].Init();
-        delay_mem[1].Init();
-
         param[0].init("Time", &time, time);
         param[1].init("Color", &color, color);
         param[2].init("Pan", &pan, pan);
         param[3].init("Feedb", &level, level);
+        param[4].init("Mod", &mod_depth, mod_depth);
+        param[5].init("Rate", &mod_rate, mod_rate);
     }
 
     float delay = 0;
     float t_32 = 0;
+    float lfo_phase = 0;
+    float lfo_freq = 0;
+    float last_delay[2] = {};
+
+    // Linear per sample ramp from the last block's read position to the new one.
+    static void ramp(float *out, float from, float to)
+    {
+        const float step = (to - from) / FRAME_BUFFER_SIZE;
+
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+        {
+            from += step;
+            out[i] = from;
+        }
+    }
 
     bool calc_t_step32()
     {
@@ -96,38 +190,95 @@ struct Delay : public Engine
 
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
+        float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
+
+        if (delay_buffer[1].get() == nullptr)
+        {
+            // A failed acquire() is not retried - don't take the left channel again.
+            if (delay_buffer[1].failed || delay_buffer[0].acquire() == nullptr || delay_buffer[1].acquire() == nullptr)
+            {
+                if (delay_buffer[0].get() != nullptr)
+                    delay_buffer[0].release(); // no use without the right channel
+
+                of.out = ins[0];
+                of.aux = ins[1];
+                return;
+            }
+
+            for (int c = 0; c < 2; c++)
+                delay_mem[c].Init(delay_buffer[c].get(), Codec::Encode(0)); // 0 is not silence in every format
+        }
+
         sync_params();
 
         int n = 1 + time / t_32;
         float d = n * t_32 * machine::SAMPLE_RATE;
 
-        if (fabsf(d - delay) > machine::SAMPLE_RATE / 10)
+        bool jump = fabsf(d - delay) > machine::SAMPLE_RATE / 10;
+        if (jump)
             delay = d;
         else
             ONE_POLE(delay, d, 0.01f);
 
-        float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
+        // Stereo LFO in quadrature, evaluated per block - it only lengthens the delay.
+        lfo_phase += lfo_freq * FRAME_BUFFER_SIZE;
+        if (lfo_phase >= 1.f)
+            lfo_phase -= 1.f;
+
+        float depth = mod_depth * max_mod_depth;
+        float lfo_sin, lfo_cos;
+        fast_math::sincos(2.f * fast_math::kPi * lfo_phase, &lfo_sin, &lfo_cos);
+        float target[2] = {
+            delay + depth * (1.f + lfo_sin),
+            delay + depth * (1.f + lfo_cos),
+        };
 
+        float *delays[] = {delayL, delayR};
+
+        for (int c = 0; c < 2; c++)
+        {
+            // The block is read before it is written and the Hermite read looks one sample ahead.
+            CONSTRAIN(target[c], (float)FRAME_BUFFER_SIZE + 2, (float)delay_len - 3);
+
+            if (jump)
+                last_delay[c] = target[c];
+
+            ramp(delays[c], last_delay[c], target[c]);
+            last_delay[c] = target[c];
+        }
+
+        delay_mem[0].ReadHermite(tapL, delayL, FRAME_BUFFER_SIZE, Codec::Decode);
+        delay_mem[1].ReadHermite(tapR, delayR, FRAME_BUFFER_SIZE, Codec::Decode);
+
+        // The filters are recursive - one pass per channel ...
         for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
         {
-            float readL = DelayRead(delay_mem[0], (int)delay);
-            float readR = DelayRead(delay_mem[1], (int)delay);
+            auto inL = filterLP[0].Process<stmlib::FILTER_MODE_LOW_PASS>(ins[0][i]);
+            filteredL[i] = filterHP[0].Process<stmlib::FILTER_MODE_HIGH_PASS>(inL);
+        }
 
-            auto inL = ins[0][i];
-            auto inR = ins[1][i];
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+        {
+            auto inR = filterLP[1].Process<stmlib::FILTER_MODE_LOW_PASS>(ins[1][i]);
+            filteredR[i] = filterHP[1].Process<stmlib::FILTER_MODE_HIGH_PASS>(inR);
+        }
 
-            inL = filterLP[0].Process<stmlib::FILTER_MODE_LOW_PASS>(inL);
-            inL = filterHP[0].Process<stmlib::FILTER_MODE_HIGH_PASS>(inL);
-            inR = filterLP[1].Process<stmlib::FILTER_MODE_LOW_PASS>(inR);
-            inR = filterHP[1].Process<stmlib::FILTER_MODE_HIGH_PASS>(inR);
+        // ... the feedback mix and output are element wise and vectorize.
+        const float gainL = pan * 2 * level;
+        const float gainR = (1 - pan) * 2 * level;
 
-            DelayWrite(delay_mem[0], (readR + inL * (0 + pan) * 2) * level);
-            DelayWrite(delay_mem[1], (readL + inR * (1 - pan) * 2) * level);
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+        {
+            feedL[i] = Codec::Encode(tapR[i] * level + filteredL[i] * gainL);
+            feedR[i] = Codec::Encode(tapL[i] * level + filteredR[i] * gainR);
 
-            bufferL[i] = readL + ins[0][i];
-            bufferR[i] = readR + ins[1][i];
+            bufferL[i] = tapL[i] + ins[0][i];
+            bufferR[i] = tapR[i] + ins[1][i];
         }
 
+        delay_mem[0].Write(feedL, FRAME_BUFFER_SIZE);
+        delay_mem[1].Write(feedR, FRAME_BUFFER_SIZE);
+
         of.out = bufferL;
         of.aux = bufferR;
     }
@@ -145,11 +296,19 @@ struct Delay : public Engine
         filterLP[1].set_f<stmlib::FREQUENCY_DIRTY>(lowpassFreq);
         filterHP[0].set_f<stmlib::FREQUENCY_DIRTY>(highpassFreq);
         filterHP[1].set_f<stmlib::FREQUENCY_DIRTY>(highpassFreq);
+
+        lfo_freq = 0.05f * std::pow(100.f, mod_rate) / machine::SAMPLE_RATE; // 0.05Hz - 5Hz
     }
 
     char time_info[64] = "Time";
     void onDisplay(uint8_t *buffer) override
     {
+        if (delay_buffer[0].failed || delay_buffer[1].failed)
+        {
+            gfx::drawString(buffer, 4, 32, "<<<< OUT OF RAM >>>>");
+            return;
+        }
+
         if (calc_t_step32())
         {
             int n = 1 + time / t_32;
@@ -174,7 +333,8 @@ struct Delay : public Engine
 
 void init_delay()
 {
-    machine::add<Delay>(FX, "Delay");
+    machine::add<Metered<Delay<PCM16>>>(FX, "Delay");
+    machine::add<Metered<Delay<MuLaw>>>(FX, "Delay-uLaw");
 }
 
 MACHINE_INIT(init_delay);
\ No newline at end of file
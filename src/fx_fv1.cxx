@@ -1,4 +1,5 @@
 #include "machine.h"
+#include "cpu_meter.hxx"
 #include <stdio.h>
 
 #ifndef PROGMEM
@@ -95,8 +96,8 @@ struct FXEngine : public Engine
 
 void init_fv1()
 {
-    machine::add<FXEngine<1, 15>>(machine::FX, "Gated-Reverb", 1.f, 0.5f, 0.5f, 0.5f, "D/W", "PreD", "G-Time", "Damp");
-    machine::add<FXEngine<0>>(machine::FX, "Reverb-HP-LP", 1.f, 0.5f, 0.5f, 0.5f, "D/W", "Reverb", "HP", "LP");
+    machine::add<Metered<FXEngine<1, 15>>>(machine::FX, "Gated-Reverb", 1.f, 0.5f, 0.5f, 0.5f, "D/W", "PreD", "G-Time", "Damp");
+    machine::add<Metered<FXEngine<0>>>(machine::FX, "Reverb-HP-LP", 1.f, 0.5f, 0.5f, 0.5f, "D/W", "Reverb", "HP", "LP");
 }
 
 MACHINE_INIT(init_fv1);
\ No newline at end of file
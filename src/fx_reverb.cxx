@@ -26,6 +26,8 @@
 #include "stmlib/stmlib.h"
 #include "stmlib/dsp/filter.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "machine_arena.hxx"
 #include <vector>
 
 #include "clouds/dsp/fx/reverb.h"
@@ -39,7 +41,7 @@ struct CloudsReverb : public Engine
     float feedback;
     float gain;
 
-    uint16_t buffer[16384];
+    machine_arena::Buffer<uint16_t, 16384> buffer;
     clouds::Reverb fx_;
 
     float bufferL[FRAME_BUFFER_SIZE];
@@ -48,8 +50,6 @@ struct CloudsReverb : public Engine
     CloudsReverb() : Engine(AUDIO_PROCESSOR)
     {
         raw = 1.f;
-        memset(buffer, 0, sizeof(buffer));
-        fx_.Init(buffer);
 
         param[0].init("D/W", &raw, raw);
         param[1].init("Reverb", &reverb_amount, 0.75f);
@@ -59,14 +59,26 @@ struct CloudsReverb : public Engine
 
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
+        float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
+
+        if (buffer.get() == nullptr)
+        {
+            if (buffer.acquire() == nullptr)
+            {
+                of.out = ins[0];
+                of.aux = ins[1];
+                return;
+            }
+
+            fx_.Init(buffer.get());
+        }
+
         fx_.set_amount(reverb_amount * 0.54f);
         fx_.set_diffusion(0.7f);
         fx_.set_time(0.35f + 0.63f * reverb_amount);
         fx_.set_input_gain(gain * 0.1f); // 0.1f);
         fx_.set_lp(0.6f + 0.37f * feedback);
 
-        float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
-
         for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
         {
             bufferL[i] = ins[0][i];
@@ -84,6 +96,174 @@ struct CloudsReverb : public Engine
         of.out = bufferL;
         of.aux = bufferR;
     }
+
+    void onDisplay(uint8_t *buffer) override
+    {
+        if (this->buffer.failed)
+        {
+            gfx::drawString(buffer, 4, 32, "<<<< OUT OF RAM >>>>");
+            return;
+        }
+
+        gfx::drawEngine(buffer, this);
+    }
+};
+
+// One reverb tank shared by all Rev-Bus instances (send/return). Each instance
+// adds its input times its send level to the bus. The bus runs once per block,
+// on the first instance that is processed in that block - the return, which
+// outputs the wet signal. The return is one block late, so that the sends of
+// all tracks are in.
+struct ReverbBus
+{
+    float reverb_amount = 0.75f;
+    float feedback = 0.5f;
+    float gain = 1.f;
+
+    machine_arena::Buffer<uint16_t, 16384> buffer;
+    clouds::Reverb fx_;
+
+    int refs = 0;
+    uint32_t last_t = UINT32_MAX;
+    const void *returner = nullptr;
+
+    float sendL[FRAME_BUFFER_SIZE] = {};
+    float sendR[FRAME_BUFFER_SIZE] = {};
+    float wetL[FRAME_BUFFER_SIZE] = {};
+    float wetR[FRAME_BUFFER_SIZE] = {};
+
+    static ReverbBus &get()
+    {
+        static ReverbBus bus;
+        return bus;
+    }
+
+    bool acquire()
+    {
+        if (buffer.get() == nullptr)
+        {
+            if (buffer.acquire() == nullptr)
+                return false;
+
+            fx_.Init(buffer.get());
+        }
+
+        return true;
+    }
+
+    void release()
+    {
+        if (--refs == 0)
+        {
+            buffer.release();
+            returner = nullptr;
+            last_t = UINT32_MAX;
+            std::fill(std::begin(sendL), std::end(sendL), 0);
+            std::fill(std::begin(sendR), std::end(sendR), 0);
+        }
+    }
+
+    // Returns true if the caller is the return of this block.
+    bool process(uint32_t t, const void *caller)
+    {
+        if (last_t != t)
+        {
+            last_t = t;
+            returner = caller;
+
+            fx_.set_amount(reverb_amount * 0.54f);
+            fx_.set_diffusion(0.7f);
+            fx_.set_time(0.35f + 0.63f * reverb_amount);
+            fx_.set_input_gain(gain * 0.1f);
+            fx_.set_lp(0.6f + 0.37f * feedback);
+
+            std::copy(std::begin(sendL), std::end(sendL), wetL);
+            std::copy(std::begin(sendR), std::end(sendR), wetR);
+            std::fill(std::begin(sendL), std::end(sendL), 0);
+            std::fill(std::begin(sendR), std::end(sendR), 0);
+
+            fx_.Process(wetL, wetR, FRAME_BUFFER_SIZE);
+        }
+
+        return returner == caller;
+    }
+};
+
+struct ReverbSend : public Engine
+{
+    float send = 0.5f;
+
+    float bufferL[FRAME_BUFFER_SIZE];
+    float bufferR[FRAME_BUFFER_SIZE];
+
+    bool is_return = false;
+
+    ReverbSend() : Engine(AUDIO_PROCESSOR)
+    {
+        auto &bus = ReverbBus::get();
+        bus.refs++;
+
+        // the tank settings are shared - keep the current values
+        param[0].init("Send", &send, send);
+        param[1].init("Reverb", &bus.reverb_amount, bus.reverb_amount);
+        param[2].init("Damp", &bus.feedback, bus.feedback);
+        param[3].init("Gain", &bus.gain, bus.gain);
+    }
+
+    ~ReverbSend()
+    {
+        ReverbBus::get().release();
+    }
+
+    void process(const ControlFrame &frame, OutputFrame &of) override
+    {
+        auto &bus = ReverbBus::get();
+        float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
+
+        if (!bus.acquire())
+        {
+            of.out = ins[0];
+            of.aux = ins[1];
+            return;
+        }
+
+        is_return = bus.process(frame.t, this);
+
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+        {
+            bus.sendL[i] += ins[0][i] * send;
+            bus.sendR[i] += ins[1][i] * send;
+        }
+
+        if (is_return)
+        {
+            for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            {
+                bufferL[i] = ins[0][i] + bus.wetL[i];
+                bufferR[i] = ins[1][i] + bus.wetR[i];
+            }
+
+            of.out = bufferL;
+            of.aux = bufferR;
+        }
+        else
+        {
+            of.out = ins[0];
+            of.aux = ins[1];
+        }
+    }
+
+    void onDisplay(uint8_t *buffer) override
+    {
+        if (ReverbBus::get().buffer.failed)
+        {
+            gfx::drawString(buffer, 4, 32, "<<<< OUT OF RAM >>>>");
+            return;
+        }
+
+        gfx::drawEngine(buffer, this);
+        gfx::drawString(buffer, 10, 28, is_return ? "RETURN" : "SEND", 0);
+    }
 };
 
 #include "clouds/dsp/fx/diffuser.h"
@@ -125,7 +305,8 @@ struct CloudsDiffuser : public Engine
 
 void init_reverb()
 {
-    machine::add<CloudsReverb>(FX, "Reverb");
+    machine::add<Metered<CloudsReverb>>(FX, "Reverb");
+    machine::add<Metered<ReverbSend>>(FX, "Rev-Bus");
     //machine::add<CloudsDiffuser>(FX, "Diffusor");
 }
 
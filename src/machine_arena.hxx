@@ -0,0 +1,123 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Large DSP buffers are kept out of the engine objects with machine_arena::Buffer,
+// acquired on the first process() call and returned by the engine's destructor,
+// so a loaded but idle machine - or one that is never loaded - costs no buffer RAM.
+//
+// Engines are allocated by the firmware (machine::malloc), the buffers come from
+// the same heap. There is no pooling: switching machines can still fragment the
+// heap, and a failed acquire() is shown as OUT OF RAM by the engine.
+
+// Heap the machines are allocated from - the OCRAM (RAM2) of the Teensy 4.0 -
+// and the number of tracks sharing it.
+#ifndef MACHINE_HEAP_SIZE
+#define MACHINE_HEAP_SIZE (512 * 1024)
+#endif
+
+#ifndef MACHINE_TRACKS
+#define MACHINE_TRACKS 4
+#endif
+
+// RAM a machine may take so that every track can hold any machine. Checked at
+// compile time for each Buffer, and by test/memory.cxx per machine.
+#ifndef MACHINE_TRACK_BUDGET
+#define MACHINE_TRACK_BUDGET (MACHINE_HEAP_SIZE / MACHINE_TRACKS)
+#endif
+
+namespace machine_arena
+{
+    // Bytes held by all Buffers, as requested - what the device heap serves.
+    inline size_t &held()
+    {
+        static size_t bytes = 0;
+        return bytes;
+    }
+
+    // DSP buffer owned by an engine - the memory is taken on the first acquire()
+    // and returned by release() or the destructor.
+    template <typename T, size_t N>
+    struct Buffer
+    {
+        static_assert(sizeof(T) * N <= MACHINE_TRACK_BUDGET, "buffer exceeds MACHINE_TRACK_BUDGET");
+
+        T *ptr = nullptr;
+        bool failed = false;
+
+        Buffer()
+        {
+        }
+
+        Buffer(const Buffer &) = delete;
+        Buffer &operator=(const Buffer &) = delete;
+
+        ~Buffer()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (ptr != nullptr)
+            {
+                ::free(ptr);
+                held() -= sizeof(T) * N;
+            }
+
+            ptr = nullptr;
+            failed = false;
+        }
+
+        T *acquire()
+        {
+            if (ptr == nullptr && !failed)
+            {
+                ptr = (T *)::malloc(sizeof(T) * N);
+                failed = ptr == nullptr;
+
+                if (ptr != nullptr)
+                    held() += sizeof(T) * N;
+            }
+
+            return ptr;
+        }
+
+        T *get() const
+        {
+            return ptr;
+        }
+
+        static constexpr size_t size()
+        {
+            return N;
+        }
+    };
+} // namespace machine_arena
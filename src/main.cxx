@@ -35,6 +35,7 @@ int main()
     MACHINE_INIT(init_voltage);
     MACHINE_INIT(init_midi_monitor);
     MACHINE_INIT(init_midi_clock);
+    MACHINE_INIT(init_cpu_monitor);
     MACHINE_INIT(init_quantizer);
     MACHINE_INIT(init_peaks);
     MACHINE_INIT(init_braids);
@@ -25,6 +25,8 @@
 //
 
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "output_conversion.hxx"
 
 using namespace machine;
 
@@ -35,7 +37,7 @@ class MidiClock : public Engine
     uint8_t impulse = 100;
     int count_down = 0;
 
-    int16_t buffer[FRAME_BUFFER_SIZE] = {};
+    float buffer[FRAME_BUFFER_SIZE] = {};
 
 public:
     MidiClock() : Engine(SEQUENCER_ENGINE | OUT_EQ_VOLT)
@@ -101,7 +103,8 @@ public:
         }
 
         int16_t a = count_down-- > 0 ? INT16_MAX : 0;
-        of.push<int16_t>(&a, 1);
+        output_conversion::fill(buffer, a * output_conversion::kInt16VoltsPerLsb);
+        of.out = buffer;
     }
 
     void onDisplay(uint8_t *buffer) override
@@ -118,7 +121,7 @@ public:
 
 void init_midi_clock()
 {
-    machine::add<MidiClock>("MIDI", "Clock");
+    machine::add<Metered<MidiClock>>("MIDI", "Clock");
 }
 
 MACHINE_INIT(init_midi_clock);
\ No newline at end of file
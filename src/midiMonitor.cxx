@@ -1,4 +1,5 @@
 #include "machine.h"
+#include "cpu_meter.hxx"
 #include "stmlib/algorithms/voice_allocator.h"
 #include <map>
 
@@ -85,5 +86,5 @@ struct MidiMonitor : public machine::MidiEngine
 
 void init_midi_monitor()
 {
-    machine::add<MidiMonitor>("MIDI", "Monitor");
+    machine::add<Metered<MidiMonitor>>("MIDI", "Monitor");
 }
\ No newline at end of file
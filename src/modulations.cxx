@@ -24,6 +24,8 @@
 //
 
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "audio_rate_modulation.hxx"
 #include "stmlib/utils/random.h"
 
 struct ModulationBase : machine::ModulationSource
@@ -31,6 +33,36 @@ struct ModulationBase : machine::ModulationSource
     float value;
     float attenuverter = 0;
 
+    // Updates value - called once per block, each instance has a single target.
+    virtual void evaluate(machine::ControlFrame &frame) = 0;
+
+    // Updates parameter names that depend on the parameter values.
+    virtual void update_names()
+    {
+    }
+
+    // Per sample values of the last evaluate() - audio rate sources only.
+    virtual const float *samples()
+    {
+        return nullptr;
+    }
+
+    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    {
+        evaluate(frame);
+
+        target.modulate(value * attenuverter);
+
+        if (const float *s = samples())
+        {
+            if (float *lane = audio_rate::write(target.value, frame.t))
+            {
+                for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                    lane[i] += (s[i] - value) * attenuverter;
+            }
+        }
+    }
+
     void display(uint8_t *buffer, int x, int y) override
     {
         if (src > 0)
@@ -81,10 +113,44 @@ struct CV : ModulationBase
         param[1].init(".", &attenuverter, attenuverter, -3, +3);
     }
 
-    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    void evaluate(machine::ControlFrame &frame) override
     {
         value = machine::get_cv(cv_channel);
-        target.modulate(value * attenuverter);
+    }
+};
+
+// Audio input as modulation source. Parameters get the block average, the ones
+// an engine follows at audio rate (e.g. FM on Freq) get every sample.
+struct AUX : ModulationBase
+{
+    uint8_t channel = 0;
+    const float *buffer = nullptr;
+
+    void eeprom(std::function<void(void *, size_t)> read_write) override
+    {
+        read_write(&channel, sizeof(channel));
+        read_write(&attenuverter, sizeof(attenuverter));
+    }
+
+    AUX()
+    {
+        param[0].init("SRC", &channel, channel, 0, 1);
+        param[0].print_value = [&](char *tmp)
+        {
+            sprintf(tmp, channel == 0 ? "L" : "R");
+        };
+        param[1].init(".", &attenuverter, attenuverter, -1, +1);
+    }
+
+    void evaluate(machine::ControlFrame &frame) override
+    {
+        buffer = machine::get_aux(channel == 0 ? machine::AUX_L : machine::AUX_R);
+        value = audio_rate::average(buffer, machine::FRAME_BUFFER_SIZE);
+    }
+
+    const float *samples() override
+    {
+        return buffer;
     }
 };
 
@@ -118,7 +184,7 @@ struct RND : ModulationBase
         param[1].init(".", &attenuverter, attenuverter, -1, +1);
     }
 
-    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    void evaluate(machine::ControlFrame &frame) override
     {
         if (tr_channel == 0)
         {
@@ -130,8 +196,6 @@ struct RND : ModulationBase
             if (machine::get_trigger(tr_channel - 1))
                 this->value = randomf(-10, 10);
         }
-
-        target.modulate(this->value * this->attenuverter);
     }
 };
 
@@ -173,9 +237,17 @@ struct Envelope : ModulationBase
         param[3].init(".", &attenuverter, attenuverter, -1, +1);
     }
 
-    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    int16_t _attack = -1;
+    int16_t _decay = -1;
+
+    void evaluate(machine::ControlFrame &frame) override
     {
-        _processor.Update(attack >> 1, decay >> 1);
+        if (attack != _attack || decay != _decay)
+        {
+            _attack = attack;
+            _decay = decay;
+            _processor.Update(attack >> 1, decay >> 1);
+        }
 
         bool trigger = false;
         if (tr_channel == 0)
@@ -191,8 +263,6 @@ struct Envelope : ModulationBase
             _processor.Trigger(braids::ENV_SEGMENT_ATTACK);
 
         value = ((float)_processor.Render() / UINT16_MAX) * 10.f;
-
-        target.modulate(value * this->attenuverter);
     }
 };
 
@@ -246,11 +316,22 @@ struct LFO : ModulationBase
         }
     }
 
-    uint32_t last_trig = 0;
-    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    int16_t _shape = -1;
+    int32_t _rate = -1;
+
+    void evaluate(machine::ControlFrame &frame) override
     {
-        _processor.set_shape((peaks::LfoShape)shape);
-        _processor.set_rate(rate);
+        if (shape != _shape)
+        {
+            _shape = shape;
+            _processor.set_shape((peaks::LfoShape)shape);
+        }
+
+        if (rate != _rate)
+        {
+            _rate = rate;
+            _processor.set_rate(rate);
+        }
 
         peaks::GateFlags flags[] = {peaks::GATE_FLAG_LOW, peaks::GATE_FLAG_LOW};
 
@@ -278,10 +359,9 @@ struct LFO : ModulationBase
         int16_t ivalue = 0;
         _processor.Process(flags, &ivalue, 1);
         value = (float)ivalue / INT16_MAX * 10.f;
-        target.modulate(value * this->attenuverter);
     }
 
-    void display(uint8_t *buffer, int x, int y) override
+    void update_names() override
     {
         if (mode == peaks::LFO_SHAPE_LAST)
         {
@@ -306,18 +386,106 @@ struct LFO : ModulationBase
                 param[1].name = ">?????";
                 break;
             }
+        }
+    }
 
+    void display(uint8_t *buffer, int x, int y) override
+    {
+        if (mode == peaks::LFO_SHAPE_LAST)
+        {
+            update_names();
             ModulationBase::display(buffer, x, y);
         }
     }
 };
 
+// Subscriber of a named source instance (bus) that is shared by all parameters on all
+// tracks - the bus is rendered once per block, each subscriber has its own attenuverter.
+// The track trigger ("!") of a bus is the trigger of any subscribing track, applied one block later.
+template <class T, int bus_index>
+struct Shared : ModulationBase
+{
+    static T &bus()
+    {
+        static T instance;
+        return instance;
+    }
+
+    static bool &bus_trigger()
+    {
+        static bool pending = false;
+        return pending;
+    }
+
+    // Block (ControlFrame::t) the bus was last rendered for.
+    static uint32_t &bus_t()
+    {
+        static uint32_t t = UINT32_MAX;
+        return t;
+    }
+
+    void eeprom(std::function<void(void *, size_t)> read_write) override
+    {
+        read_write(&attenuverter, sizeof(attenuverter));
+        bus().eeprom(read_write);
+    }
+
+    Shared()
+    {
+        auto &b = bus();
+
+        for (size_t i = 0; i < LEN_OF(param); i++)
+        {
+            if (b.param[i].value == &b.attenuverter)
+                param[i].init(".", &attenuverter, attenuverter, b.param[i].min.f, b.param[i].max.f);
+            else
+                param[i] = b.param[i];
+        }
+    }
+
+    void evaluate(machine::ControlFrame &frame) override
+    {
+        auto &b = bus();
+
+        if (bus_t() != frame.t)
+        {
+            machine::ControlFrame bus_frame;
+            memcpy(&bus_frame, &frame, sizeof(machine::ControlFrame));
+            bus_frame.trigger = bus_trigger();
+            bus_trigger() = false;
+
+            bus_t() = frame.t;
+            b.evaluate(bus_frame);
+        }
+
+        bus_trigger() |= frame.trigger;
+        value = b.value;
+    }
+
+    void display(uint8_t *buffer, int x, int y) override
+    {
+        auto &b = bus();
+        b.update_names();
+
+        for (size_t i = 0; i < LEN_OF(param); i++)
+            if (param[i].value != &attenuverter)
+                param[i].name = b.param[i].name;
+
+        ModulationBase::display(buffer, x, y);
+    }
+};
+
 void init_modulations()
 {
-    machine::add_modulation_source<CV>("CV");
-    machine::add_modulation_source<RND>("RND");
-    machine::add_modulation_source<Envelope>("ENV");
-    machine::add_modulation_source<LFO<peaks::LFO_SHAPE_LAST>>("LFO");
+    machine::add_modulation_source<MeteredModulation<CV>>("CV");
+    machine::add_modulation_source<MeteredModulation<AUX>>("AUX");
+    machine::add_modulation_source<MeteredModulation<RND>>("RND");
+    machine::add_modulation_source<MeteredModulation<Envelope>>("ENV");
+    machine::add_modulation_source<MeteredModulation<LFO<peaks::LFO_SHAPE_LAST>>>("LFO");
+    machine::add_modulation_source<MeteredModulation<Shared<LFO<peaks::LFO_SHAPE_LAST>, 0>>>("LFO-A");
+    machine::add_modulation_source<MeteredModulation<Shared<LFO<peaks::LFO_SHAPE_LAST>, 1>>>("LFO-B");
+    machine::add_modulation_source<MeteredModulation<Shared<Envelope, 0>>>("ENV-A");
+    machine::add_modulation_source<MeteredModulation<Shared<Envelope, 1>>>("ENV-B");
 }
 
 MACHINE_INIT(init_modulations);
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+
+// Conversion kernels for engines that render integer samples. Instead of
+// OutputFrame::push(), which converts into a temporary buffer, an engine converts
+// straight into its own float buffer and sets of.out.
+
+namespace output_conversion
+{
+    // Volts per LSB of the integer types OutputFrame::push() takes, as libmachine
+    // converts them: int16_t audio is 5V at full scale, int32_t is pitch CV in the
+    // units of ControlFrame::cv_voltage_, PITCH_PER_OCTAVE per volt.
+    constexpr float kInt16VoltsPerLsb = 5.f / INT16_MAX;
+    constexpr float kInt32VoltsPerLsb = 1.f / machine::PITCH_PER_OCTAVE;
+
+    // Unrolled by four - no float SIMD on the Cortex-M7, but the FPU dual issues
+    // the independent converts/multiplies, and the host compiler vectorizes it.
+    inline void convert(const int16_t *__restrict in, float *__restrict out, size_t size, float gain = kInt16VoltsPerLsb)
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= size; i += 4)
+        {
+            out[i + 0] = (float)in[i + 0] * gain;
+            out[i + 1] = (float)in[i + 1] * gain;
+            out[i + 2] = (float)in[i + 2] * gain;
+            out[i + 3] = (float)in[i + 3] * gain;
+        }
+
+        for (; i < size; i++)
+            out[i] = (float)in[i] * gain;
+    }
+
+    inline void convert(const int32_t *__restrict in, float *__restrict out, size_t size, float gain = kInt32VoltsPerLsb)
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= size; i += 4)
+        {
+            out[i + 0] = (float)in[i + 0] * gain;
+            out[i + 1] = (float)in[i + 1] * gain;
+            out[i + 2] = (float)in[i + 2] * gain;
+            out[i + 3] = (float)in[i + 3] * gain;
+        }
+
+        for (; i < size; i++)
+            out[i] = (float)in[i] * gain;
+    }
+
+    // Gain ramps linearly from gain_from (previous block) to gain_to (last sample).
+    inline void convert(const int16_t *__restrict in, float *__restrict out, size_t size, float gain_from, float gain_to)
+    {
+        const float step = (gain_to - gain_from) / size;
+        float gain = gain_from;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            gain += step;
+            out[i] = (float)in[i] * gain;
+        }
+    }
+
+    // Control rate outputs - one value held for the whole block.
+    inline void fill(float *out, float value, size_t size = machine::FRAME_BUFFER_SIZE)
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= size; i += 4)
+        {
+            out[i + 0] = value;
+            out[i + 1] = value;
+            out[i + 2] = value;
+            out[i + 3] = value;
+        }
+
+        for (; i < size; i++)
+            out[i] = value;
+    }
+} // namespace output_conversion
@@ -1,5 +1,7 @@
 #include "stmlib/stmlib.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "output_conversion.hxx"
 #include "peaks/gate_processor.h"
 #include "peaks/drums/bass_drum.h"
 #include "peaks/drums/fm_drum.h"
@@ -26,6 +28,7 @@ struct PeaksEngine : public Engine
 
     peaks::GateFlags flags[FRAME_BUFFER_SIZE];
     int16_t buffer[FRAME_BUFFER_SIZE];
+    float bufferOut[FRAME_BUFFER_SIZE];
 
     PeaksEngine(uint16_t p1 = UINT16_MAX / 2,
                 uint16_t p2 = UINT16_MAX / 2,
@@ -74,7 +77,8 @@ struct PeaksEngine : public Engine
 
         _processor.Process(flags, buffer, FRAME_BUFFER_SIZE);
 
-        of.push(buffer, LEN_OF(buffer));
+        output_conversion::convert(buffer, bufferOut, FRAME_BUFFER_SIZE);
+        of.out = bufferOut;
     }
 
     void onDisplay(uint8_t *buffer) override
@@ -124,16 +128,16 @@ public:
 
 void init_peaks()
 {
-    add<PeaksEngine<peaks::FmDrum, TRIGGER_INPUT, 0, 3, 1, 2>>(DRUM, "FM-Drum", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Freq.", "Noise", "FM", "Decay");
+    add<Metered<PeaksEngine<peaks::FmDrum, TRIGGER_INPUT, 0, 3, 1, 2>>>(DRUM, "FM-Drum", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Freq.", "Noise", "FM", "Decay");
     
-    add<PeaksEngine<peaks::BassDrum, TRIGGER_INPUT>>(DRUM, "808ish-BD", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Pitch", "Punch", "Tone", "Decay");
-    add<PeaksEngine<peaks::SnareDrum, TRIGGER_INPUT, 0, 2, 1, 3>>(DRUM, "808ish-SD", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Pitch", "Snappy", "Tone", "Decay");
+    add<Metered<PeaksEngine<peaks::BassDrum, TRIGGER_INPUT>>>(DRUM, "808ish-BD", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Pitch", "Punch", "Tone", "Decay");
+    add<Metered<PeaksEngine<peaks::SnareDrum, TRIGGER_INPUT, 0, 2, 1, 3>>>(DRUM, "808ish-SD", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Pitch", "Snappy", "Tone", "Decay");
 
-    add<Hihat808>(DRUM, "808ish-HiHat");
+    add<Metered<Hihat808>>(DRUM, "808ish-HiHat");
 
     //add<PeaksEngine<peaks::HighHat, TRIGGER_INPUT>>(DRUM, "808ish-HiHat", INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, "Decay");
-    add<PeaksEngine<peaks::MultistageEnvelope, TRIGGER_INPUT>>(CV, "Envelope", 0, INT16_MAX, INT16_MAX, INT16_MAX, "Attack", "Decay", "Sustain", "Release");
-    add<PeaksEngine<peaks::Lfo, TRIGGER_INPUT>>(CV, "LFO", 0, 0, INT16_MAX, 0, "Freq.", "Shape", "Param", "Phase");
+    add<Metered<PeaksEngine<peaks::MultistageEnvelope, TRIGGER_INPUT>>>(CV, "Envelope", 0, INT16_MAX, INT16_MAX, INT16_MAX, "Attack", "Decay", "Sustain", "Release");
+    add<Metered<PeaksEngine<peaks::Lfo, TRIGGER_INPUT>>>(CV, "LFO", 0, 0, INT16_MAX, 0, "Freq.", "Shape", "Param", "Phase");
 }
 
 MACHINE_INIT(init_peaks);
\ No newline at end of file
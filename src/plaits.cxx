@@ -1,22 +1,35 @@
 #include "stmlib/stmlib.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
 #include "plaits/dsp/voice.h"
+#include "sample_rate_conversion_filters.hxx"
+#include "audio_rate_modulation.hxx"
 
 using namespace machine;
 
-template <int engine, int output = 0> // output=0 -> out, output=1 -> aux, output=3 -> stereo
-struct PlaitsEngine : public Engine
+template <int engine, int output = 0, int decimation = 1> // output=0 -> out, output=1 -> aux, output=3 -> stereo
+struct PlaitsEngine : public Engine                          // decimation=2 -> renders at half rate (24kHz)
 {
+    static_assert(decimation == 1 || decimation == 2, "decimation 1 or 2");
+
     plaits::Modulations modulations;
-    uint8_t buffer[16384];
-    stmlib::BufferAllocator allocator;
-    plaits::Voice voice;
+    plaits::SingleEngineVoice<engine> voice;
     plaits::Patch patch;
 
     float bufferOut[machine::FRAME_BUFFER_SIZE];
     float bufferAux[machine::FRAME_BUFFER_SIZE];
+
+    static constexpr int kRenderSize = machine::FRAME_BUFFER_SIZE / decimation;
+    static constexpr float kPitchOffset = decimation == 2 ? 12.f : 0.f; // half rate -> one octave up
+
+    float renderOut[kRenderSize];
+    float renderAux[kRenderSize];
+    stmlib::SampleRateConverter<stmlib::SRC_UP, decimation, 32> upsamplerOut;
+    stmlib::SampleRateConverter<stmlib::SRC_UP, decimation, 32> upsamplerAux;
     float out_aux_mix = 0;
     float _pitch = 0;
+    audio_rate::Input _pitch_mod{&_pitch}; // FM
+    float fm_notes[kRenderSize];
     float _base_pitch = machine::DEFAULT_NOTE;
 
     stmlib::HysteresisQuantizer chord_index_quantizer_;
@@ -29,9 +42,9 @@ struct PlaitsEngine : public Engine
     {
         chord_index_quantizer_.Init();
 
-        memset(buffer, 0, sizeof(buffer));
-        allocator.Init(buffer, 16384);
-        voice.Init(&allocator);
+        voice.Init();
+        upsamplerOut.Init();
+        upsamplerAux.Init();
 
         memset(&modulations, 0, sizeof(patch));
         patch.engine = engine;
@@ -94,12 +107,12 @@ struct PlaitsEngine : public Engine
     void process(const machine::ControlFrame &frame, OutputFrame &of) override
     {
         plaits::Frame f;
-        f.out = bufferOut;
-        f.aux = bufferAux;
+        f.out = decimation == 1 ? bufferOut : renderOut;
+        f.aux = decimation == 1 ? bufferAux : renderAux;
 
-        patch.note = _base_pitch + _pitch * 12.f;
+        patch.note = _base_pitch + _pitch * 12.f + kPitchOffset;
 
-        f.size = FRAME_BUFFER_SIZE;
+        f.size = kRenderSize;
 
         float last_decay = patch.decay;
         float last_morph = patch.morph;
@@ -120,11 +133,25 @@ struct PlaitsEngine : public Engine
         modulations.trigger = frame.trigger ? 1 : 0;
 
         modulations.note = frame.cv_voltage() * 12;
-        voice.Render(patch, modulations, f);
+        if (const float *fm = _pitch_mod.read(frame.t))
+        {
+            for (int i = 0; i < kRenderSize; i++)
+                fm_notes[i] = audio_rate::average(&fm[i * decimation], decimation) * 12.f;
+
+            voice.Render(patch, modulations, f, fm_notes, audio_rate::kSubBlockSize / decimation);
+        }
+        else
+            voice.Render(patch, modulations, f);
 
         patch.decay = last_decay;
         patch.morph = last_morph;
 
+        if (decimation > 1)
+        {
+            upsamplerOut.Process(renderOut, bufferOut, kRenderSize);
+            upsamplerAux.Process(renderAux, bufferAux, kRenderSize);
+        }
+
         switch (output)
         {
         case 0:
@@ -144,27 +171,27 @@ struct PlaitsEngine : public Engine
 
 void init_plaits()
 {
-    machine::add<PlaitsEngine<0>>(machine::M_OSC, "Virt.Analog", 0.f, 1.0f, 0.0f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
-    machine::add<PlaitsEngine<1>>(machine::M_OSC, "Waveshaping", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
-    machine::add<PlaitsEngine<2>>(machine::M_OSC, "FM", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Ratio", "Mod.", "Feedb.");
-    machine::add<PlaitsEngine<3>>(machine::M_OSC, "Grain", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
-    machine::add<PlaitsEngine<4>>(machine::M_OSC, "Additive", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
-    machine::add<PlaitsEngine<5>>(machine::M_OSC, "Wavetable", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
-    machine::add<PlaitsEngine<6>>(machine::M_OSC, "Chord", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<0>>>(machine::M_OSC, "Virt.Analog", 0.f, 1.0f, 0.0f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<1>>>(machine::M_OSC, "Waveshaping", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<2>>>(machine::M_OSC, "FM", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Ratio", "Mod.", "Feedb.");
+    machine::add<Metered<PlaitsEngine<3>>>(machine::M_OSC, "Grain", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<4>>>(machine::M_OSC, "Additive", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<5>>>(machine::M_OSC, "Wavetable", 0.f, 0.8f, 0.8f, 0.75f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<6>>>(machine::M_OSC, "Chord", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
     // machine::add<PlaitsEngine<7>>(machine::M_OSC, "VowelAndSpeech", 0.f, 0.95f, 0.5f, 0.25f, "Freq", "Harm", "Timbre", "Morph");
 
-    // machine::add<PlaitsEngine<8, 2>>(machine::M_OSC, "Swarm", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
-    // machine::add<PlaitsEngine<9, 2>>(machine::M_OSC, "Noise", 4.f, 0.0f, 1.0f, 1.0f, "Cutoff", "LP/HP", "Clock", "Q");
-    // machine::add<PlaitsEngine<10, 2>>(machine::M_OSC, "Particle", 4.f, 0.8f, 0.9f, 1.0f, "Freq", "Harm", "Timbre", "Morph");
-    // machine::add<PlaitsEngine<11>>(machine::M_OSC, "String", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Decay");
-    // machine::add<PlaitsEngine<12>>(machine::M_OSC, "Modal", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Decay");
-
-    machine::add<PlaitsEngine<13, 0>>(machine::DRUM, "Analog BD", -36.f, 0.8f, 0.5f, 0.5f, "Pitch", "Drive", "Tone", "Decay");
-    machine::add<PlaitsEngine<14, 0>>(machine::DRUM, "Analog SD", 0.f, 0.5f, 0.5f, 0.5f, "Pitch", "Snappy", "Tone", "Decay");
-    machine::add<PlaitsEngine<15, 0>>(machine::DRUM, "Analog HH", 0.f, 0.5f, 0.9f, 0.6f, "Pitch", "Noise", "Tone", "Decay");
-    machine::add<PlaitsEngine<15, 1>>(machine::DRUM, "Analog HH2", 0.f, 0.5f, 0.9f, 0.6f, "Pitch", "Noise", "Tone", "Decay");
-    machine::add<PlaitsEngine<13, 1>>(machine::DRUM, "909ish-BD", -36.f, 0.8f, 0.8f, 0.75f, "Pitch", "Punch", "Tone", "Decay");
-    machine::add<PlaitsEngine<14, 1>>(machine::DRUM, "909ish-SD", -12.f, 0.5f, 0.5f, 0.5f, "Pitch", "Snappy", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<8, 2, 2>>>(machine::M_OSC, "Swarm", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<9, 2, 2>>>(machine::M_OSC, "Noise", 4.f, 0.0f, 1.0f, 1.0f, "Cutoff", "LP/HP", "Clock", "Q");
+    machine::add<Metered<PlaitsEngine<10, 2, 2>>>(machine::M_OSC, "Particle", 4.f, 0.8f, 0.9f, 1.0f, "Freq", "Harm", "Timbre", "Morph");
+    machine::add<Metered<PlaitsEngine<11, 0, 2>>>(machine::M_OSC, "String", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Decay");
+    machine::add<Metered<PlaitsEngine<12, 0, 2>>>(machine::M_OSC, "Modal", 0.f, 0.5f, 0.5f, 0.5f, "Freq", "Harm", "Timbre", "Decay");
+
+    machine::add<Metered<PlaitsEngine<13, 0>>>(machine::DRUM, "Analog BD", -36.f, 0.8f, 0.5f, 0.5f, "Pitch", "Drive", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<14, 0>>>(machine::DRUM, "Analog SD", 0.f, 0.5f, 0.5f, 0.5f, "Pitch", "Snappy", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<15, 0>>>(machine::DRUM, "Analog HH", 0.f, 0.5f, 0.9f, 0.6f, "Pitch", "Noise", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<15, 1>>>(machine::DRUM, "Analog HH2", 0.f, 0.5f, 0.9f, 0.6f, "Pitch", "Noise", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<13, 1>>>(machine::DRUM, "909ish-BD", -36.f, 0.8f, 0.8f, 0.75f, "Pitch", "Punch", "Tone", "Decay");
+    machine::add<Metered<PlaitsEngine<14, 1>>>(machine::DRUM, "909ish-SD", -12.f, 0.5f, 0.5f, 0.5f, "Pitch", "Snappy", "Tone", "Decay");
 }
 
 MACHINE_INIT(init_plaits);
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "fast_math.hxx"
 #include "plaits/dsp/engine/virtual_analog_engine.h"
 #include "plaits/dsp/envelope.h"
 #include "stmlib/algorithms/voice_allocator.h"
@@ -16,6 +18,9 @@ struct PolyVAEngine : public machine::MidiEngine
     plaits::EngineParameters parameters[LEN_OF(voice)];
     plaits::LPGEnvelope lpg[LEN_OF(voice)];
     bool enveloped[LEN_OF(voice)] = {};
+    bool active[LEN_OF(voice)] = {}; // triggered and LPG not yet decayed to silence
+
+    static constexpr float kSilentGain = 0.0001f; // -80dB
 
     stmlib::VoiceAllocator<LEN_OF(voice)> allocator;
 
@@ -69,6 +74,19 @@ struct PolyVAEngine : public machine::MidiEngine
 
         for (size_t i = 0; i < LEN_OF(voice); i++)
         {
+            if (!active[i])
+                continue;
+
+            lpg[i].ProcessPing(0.5f, short_decay, decay_tail, hf);
+
+            const float gain = lpg[i].gain();
+
+            if (gain < kSilentGain)
+            {
+                active[i] = false;
+                continue;
+            }
+
             auto p = parameters[i];
             p.note += pitch * 12.f;
             p.timbre = timbre;
@@ -77,18 +95,18 @@ struct PolyVAEngine : public machine::MidiEngine
 
             voice[i].Render(p, voiceBuff, dummy, FRAME_BUFFER_SIZE, &enveloped[i]);
 
-            lpg[i].ProcessPing(0.5f, short_decay, decay_tail, hf);
+            parameters[i].trigger = plaits::TriggerState::TRIGGER_LOW;
 
-            float l = cosf(pan[i] * M_PI / 2);
-            float r = sinf(pan[i] * M_PI / 2);
+            float l, r;
+            fast_math::sincos(pan[i] * fast_math::kPi / 2, &r, &l);
+            l *= gain;
+            r *= gain;
 
             for (int s = 0; s < FRAME_BUFFER_SIZE; s++)
             {
-                polyBuffL[s] += (voiceBuff[s] * lpg[i].gain()) * l;
-                polyBuffR[s] += (voiceBuff[s] * lpg[i].gain()) * r;
+                polyBuffL[s] += voiceBuff[s] * l;
+                polyBuffR[s] += voiceBuff[s] * r;
             }
-
-            parameters[i].trigger = plaits::TriggerState::TRIGGER_LOW;
         }
 
         of.push(polyBuffL, FRAME_BUFFER_SIZE);
@@ -107,6 +125,7 @@ struct PolyVAEngine : public machine::MidiEngine
             pan[ni] = 0.5f + stereo * (stmlib::Random::GetFloat() - 0.5f);
 
             lpg[ni].Trigger();
+            active[ni] = true;
         }
         else
         {
@@ -125,5 +144,5 @@ struct PolyVAEngine : public machine::MidiEngine
 
 void init_midi_polyVA()
 {
-    machine::add<PolyVAEngine>("MIDI", "VAx6");
+    machine::add<Metered<PolyVAEngine>>("MIDI", "VAx6");
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "stmlib/stmlib.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
 #include "rings/dsp/strummer.h"
 
 using namespace machine;
@@ -17,6 +18,7 @@ struct ResonatorEngine : public Engine
     float in[FRAME_BUFFER_SIZE];
 
     float _pitch;
+    uint8_t _polyphony = rings::kMaxPolyphony;
 
     ResonatorEngine() : Engine(TRIGGER_INPUT|VOCT_INPUT|AUDIO_PROCESSOR)
     {
@@ -30,7 +32,7 @@ struct ResonatorEngine : public Engine
         strummer.Init(0.01f, SAMPLE_RATE / FRAME_BUFFER_SIZE);
         part.Init();
         part.set_model(rings::ResonatorModel::RESONATOR_MODEL_MODAL);
-        part.set_polyphony(rings::kMaxPolyphony);
+        part.set_polyphony(_polyphony);
         memset(in, 0, sizeof(in));
 
         param[0].init_v_oct("Freq", &_pitch);
@@ -42,12 +44,16 @@ struct ResonatorEngine : public Engine
         param[3].init("Brighn.", &patch.brightness);
         param[4].init("Damping", &patch.damping);
         param[5].init("Pos", &patch.position);
+        param[6].init("Poly", &_polyphony, _polyphony, 1, rings::kMaxPolyphony);
     }
 
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
         part.set_model((rings::ResonatorModel)_model);
 
+        if (part.polyphony() != _polyphony)
+            part.set_polyphony(_polyphony);
+
         performance_state.strum = frame.trigger;
         performance_state.internal_strum = false;
         performance_state.internal_note = true;
@@ -86,7 +92,7 @@ struct ResonatorEngine : public Engine
 
 void init_rings()
 {
-    machine::add<ResonatorEngine>(M_OSC, "Resonator");
+    machine::add<Metered<ResonatorEngine>>(M_OSC, "Resonator");
 }
 
 MACHINE_INIT(init_rings);
\ No newline at end of file
@@ -28,6 +28,10 @@
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/units.h"
 
+#ifndef PROGMEM
+#include "pgmspace.h"
+#endif
+
 struct SampleEngine : public machine::Engine
 {
     float i = 1; // 0=plays the sample on init, 1=plays the sample next trig
@@ -45,6 +49,9 @@ struct SampleEngine : public machine::Engine
         const void *data;
         int addr_shift;
         virtual float get_float(int index) const = 0;
+        // Renders Hermite interpolated samples at the normalized positions pos, pos + inc, ...
+        // and returns the position following the last one.
+        virtual float render(float *out, float pos, float inc, size_t size) const = 0;
     };
 
     const sample_spec *ptr = nullptr;
@@ -53,30 +60,49 @@ struct SampleEngine : public machine::Engine
 
     float buffer[machine::FRAME_BUFFER_SIZE];
 
-    inline float Interpolate(const sample_spec &table, float index)
+    template <bool checked, class TSample>
+    static inline float fetch(const TSample &table, int index)
+    {
+        if (checked && (index < 0 || index >= table.len))
+            return 0;
+        else
+            return table.fetch(index);
+    }
+
+    template <bool checked, class TSample>
+    static inline float HermiteKernel(const TSample &table, float *out, float pos, float inc, size_t size)
     {
-        index *= table.len;
-        MAKE_INTEGRAL_FRACTIONAL(index)
-        float a = table.get_float(index_integral);
-        float b = table.get_float(index_integral + 1);
-        return a + (b - a) * index_fractional;
+        while (size--)
+        {
+            float index = pos * table.len;
+            MAKE_INTEGRAL_FRACTIONAL(index)
+            const float xm1 = fetch<checked>(table, index_integral - 1);
+            const float x0 = fetch<checked>(table, index_integral + 0);
+            const float x1 = fetch<checked>(table, index_integral + 1);
+            const float x2 = fetch<checked>(table, index_integral + 2);
+            const float c = (x1 - xm1) * 0.5f;
+            const float v = x0 - x1;
+            const float w = c + v;
+            const float a = w + v + (x2 - x0) * 0.5f;
+            const float b_neg = w + a;
+            const float f = index_fractional;
+            *out++ = (((a * f) - b_neg) * f + c) * f + x0;
+            pos += inc;
+        }
+        return pos;
     }
 
-    inline float InterpolateHermite(const sample_spec &table, float index)
-    {
-        index *= table.len;
-        MAKE_INTEGRAL_FRACTIONAL(index)
-        const float xm1 = table.get_float(index_integral - 1);
-        const float x0 = table.get_float(index_integral + 0);
-        const float x1 = table.get_float(index_integral + 1);
-        const float x2 = table.get_float(index_integral + 2);
-        const float c = (x1 - xm1) * 0.5f;
-        const float v = x0 - x1;
-        const float w = c + v;
-        const float a = w + v + (x2 - x0) * 0.5f;
-        const float b_neg = w + a;
-        const float f = index_fractional;
-        return (((a * f) - b_neg) * f + c) * f + x0;
+    // Block kernel for sample_spec::render - TSample::fetch(index) decodes one sample without bounds check.
+    template <class TSample>
+    static float RenderHermite(const TSample &table, float *out, float pos, float inc, size_t size)
+    {
+        float first = pos * table.len;
+        float last = (pos + inc * (size - 1)) * table.len;
+
+        if (std::min(first, last) >= 1 && std::max(first, last) + 3 < table.len)
+            return HermiteKernel<false>(table, out, pos, inc, size);
+        else
+            return HermiteKernel<true>(table, out, pos, inc, size);
     }
 
 public:
@@ -138,11 +164,49 @@ public:
 
         float s = std::min(start, end);
         float e = std::max(start, end);
+        float step = this->start < this->end ? inc : -inc;
 
-        while (size--)
+        // Samples [k0, k1) of this block are inside the start/end window. The
+        // positions are accumulated the way the kernel advances them, so the
+        // window edges fall on the same samples as a per sample check.
+        int k0 = 0;
+        float pos = i;
+
+        while (k0 < size && !(s <= pos && pos < e))
+        {
+            pos += step;
+            k0++;
+        }
+
+        int k1 = k0;
+
+        while (k1 < size && s <= pos && pos < e)
+        {
+            pos += step;
+            k1++;
+        }
+
+        int n = k0;
+        int m = k1 - k0;
+
+        while (n--)
+        {
+            *p++ = 0;
+            i += step;
+        }
+
+        if (m > 0)
+        {
+            i = smpl.render(p, i, step, m);
+            p += m;
+        }
+
+        n = size - k1;
+
+        while (n--)
         {
-            *p++ = s <= i && i < e ? InterpolateHermite(smpl, i) : 0;
-            i += this->start < this->end ? inc : -inc;
+            *p++ = 0;
+            i += step;
         }
 
         if (loop)
@@ -166,7 +230,20 @@ public:
 template <typename T>
 struct tsample_spec : SampleEngine::sample_spec
 {
-    virtual float get_float(int index) const;
+    inline float fetch(int index) const;
+
+    float get_float(int index) const override
+    {
+        if (index < this->len && index >= 0)
+            return fetch(index);
+        else
+            return 0;
+    }
+
+    float render(float *out, float pos, float inc, size_t size) const override
+    {
+        return SampleEngine::RenderHermite(*this, out, pos, inc, size);
+    }
 
     tsample_spec(const char *name, const T *data, size_t len, uint16_t sample_rate, int custom)
     {
@@ -178,38 +255,94 @@ struct tsample_spec : SampleEngine::sample_spec
     }
 };
 
+template <>
+inline float tsample_spec<float>::fetch(int index) const
+{
+    return reinterpret_cast<const float *>(this->data)[index << this->addr_shift];
+}
+
+template <>
+inline float tsample_spec<uint8_t>::fetch(int index) const
+{
+    return ((float)reinterpret_cast<const uint8_t *>(this->data)[index << this->addr_shift] - 127) / 128;
+}
+
+template <>
+inline float tsample_spec<int16_t>::fetch(int index) const
+{
+    return (float)reinterpret_cast<const int16_t *>(this->data)[index << this->addr_shift] / INT16_MAX;
+}
+
 struct Am6070sample : tsample_spec<uint8_t>
 {
     // https://electricdruid.net/experiments-with-variable-rate-drum-sample-playback/
     // https://electricdruid.net/wp-content/uploads/2018/06/AM6070-uLaw-DAC.pdf
 
-    // 12-bit antilog as per Am6070 datasheet
-    // for (int i = 0; i < 128; i++)
-    //     antilog[i] = (int16_t)((2 * powf(2.0, i >> 4) * ((i & 15) + 16.5) - 16.5));
+    // Decoded sample values, computed at compile time and kept in flash. The gain
+    // is applied on fetch - the same two roundings as dividing and scaling per sample.
+    struct DecodeTable
+    {
+        float value[256];
 
-    float get_float(int index) const override
+        constexpr DecodeTable() : value()
+        {
+            // 12-bit antilog as per Am6070 datasheet
+            // for (int i = 0; i < 128; i++)
+            //     antilog[i] = (int16_t)((2 * powf(2.0, i >> 4) * ((i & 15) + 16.5) - 16.5));
+            const int16_t antilog[128] = {
+                0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+                33, 37, 41, 45, 49, 53, 57, 61, 65, 69, 73, 77, 81, 86, 89, 93,
+                99, 107, 115, 123, 131, 139, 147, 155, 163, 171, 179, 187, 195, 203, 211, 219,
+                231, 247, 263, 279, 295, 311, 327, 343, 359, 375, 391, 407, 423, 439, 455, 471,
+                495, 527, 559, 591, 623, 655, 687, 719, 751, 783, 815, 847, 879, 911, 943, 975,
+                1023, 1087, 1151, 1215, 1279, 1343, 1407, 1471, 1535, 1599, 1663, 1727, 1791, 1855, 1919, 1983,
+                2079, 2207, 2335, 2463, 2591, 2719, 2847, 2975, 3103, 3231, 3359, 3487, 3615, 3743, 3871, 3999,
+                4191, 4447, 4703, 4959, 5215, 5471, 5727, 5903, 6239, 6495, 6751, 7007, 7263, 7519, 7775, 8031};
+
+            for (int ix = 0; ix < 256; ix++)
+                value[ix] = (float)((ix & 0x80) ? -antilog[ix & 0x7F] : antilog[ix]) / INT16_MAX;
+        }
+    };
+
+    static const float *decode_table()
+    {
+        static constexpr DecodeTable table PROGMEM = DecodeTable();
+        return table.value;
+    }
+
+    // Decoder view for the block kernel - Am6070sample itself must not add members,
+    // the sample tables are indexed through SampleEngine::sample_spec pointers.
+    struct Table
     {
-        static const int16_t antilog[128] = {
-            0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
-            33, 37, 41, 45, 49, 53, 57, 61, 65, 69, 73, 77, 81, 86, 89, 93,
-            99, 107, 115, 123, 131, 139, 147, 155, 163, 171, 179, 187, 195, 203, 211, 219,
-            231, 247, 263, 279, 295, 311, 327, 343, 359, 375, 391, 407, 423, 439, 455, 471,
-            495, 527, 559, 591, 623, 655, 687, 719, 751, 783, 815, 847, 879, 911, 943, 975,
-            1023, 1087, 1151, 1215, 1279, 1343, 1407, 1471, 1535, 1599, 1663, 1727, 1791, 1855, 1919, 1983,
-            2079, 2207, 2335, 2463, 2591, 2719, 2847, 2975, 3103, 3231, 3359, 3487, 3615, 3743, 3871, 3999,
-            4191, 4447, 4703, 4959, 5215, 5471, 5727, 5903, 6239, 6495, 6751, 7007, 7263, 7519, 7775, 8031};
-
-        if (index < this->len)
+        const uint8_t *data;
+        int len;
+        const float *lut;
+        float gain;
+
+        inline float fetch(int index) const
         {
-            auto ix = reinterpret_cast<const uint8_t *>(this->data)[index];
-            return (float)((ix & 0x80) ? -antilog[ix & 0x7F] : antilog[ix]) / INT16_MAX * this->addr_shift;
+            return lut[data[index]] * gain;
         }
+    };
+
+    float get_float(int index) const override
+    {
+        if (index < this->len && index >= 0)
+            return decode_table()[reinterpret_cast<const uint8_t *>(this->data)[index]] * this->addr_shift;
         else
             return 0;
     }
 
+    float render(float *out, float pos, float inc, size_t size) const override
+    {
+        Table table = {reinterpret_cast<const uint8_t *>(this->data), this->len, decode_table(), (float)this->addr_shift};
+        return SampleEngine::RenderHermite(table, out, pos, inc, size);
+    }
+
     Am6070sample(const char *name, const uint8_t *data, size_t len, uint16_t sample_rate, int custom)
         : tsample_spec<uint8_t>(name, data, len, sample_rate, custom)
     {
     }
-};
\ No newline at end of file
+};
+
+static_assert(sizeof(Am6070sample) == sizeof(SampleEngine::sample_spec), "Am6070sample is indexed as sample_spec");
\ No newline at end of file
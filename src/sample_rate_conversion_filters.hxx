@@ -23,31 +23,32 @@
 // See http://creativecommons.org/licenses/MIT/ for more information.
 //
 
-#include "sample.hxx"
+#pragma once
 
-template <>
-float tsample_spec<float>::get_float(int index) const
-{
-    if (index < this->len && index >= 0)
-        return reinterpret_cast<const float*>(this->data)[index << this->addr_shift];
-    else
-        return 0;
-}
+#include "stmlib/dsp/sample_rate_converter.h"
 
-template <>
-float tsample_spec<uint8_t>::get_float(int index) const
-{
-    if (index < this->len && index >= 0)
-        return ((float)reinterpret_cast<const uint8_t*>(this->data)[index << this->addr_shift] - 127) / 128;
-    else
-        return 0;
-}
+// Interpolation filters for stmlib::SampleRateConverter (symmetric FIR, first half stored).
+//
+// SRC_UP, 2, 32: Blackman windowed sinc, cutoff 0.225 fs (10.8kHz @ 48kHz, -6dB), gain 2.
+// Passband -1dB @ 9kHz, -3dB @ 10kHz; stopband -24dB @ 13kHz, -52dB @ 14.4kHz.
+//
+//   h[n] = 2 * 2fc * sinc(2fc * (n - 15.5)) * blackman(n), n = 0..31
 
-template <>
-float tsample_spec<int16_t>::get_float(int index) const
+namespace stmlib
 {
-    if (index < this->len && index >= 0)
-        return (float)reinterpret_cast<const int16_t*>(this->data)[index << this->addr_shift] / INT16_MAX;
-    else
-        return 0;
-}
\ No newline at end of file
+    template <>
+    struct SRC_FIR<SRC_UP, 2, 32>
+    {
+        template <int32_t i>
+        inline float Read() const
+        {
+            const float h[] = {
+                0.000000000e+00f, 1.642229350e-04f, 1.721729729e-04f, -1.760062677e-03f,
+                -2.067274378e-03f, 5.546165450e-03f, 9.460825898e-03f, -1.048691735e-02f,
+                -2.868405210e-02f, 1.087004439e-02f, 6.822942969e-02f, 7.837107824e-03f,
+                -1.435384500e-01f, -8.766294359e-02f, 3.484168911e-01f, 8.235028399e-01f,
+            };
+            return h[i];
+        }
+    };
+} // namespace stmlib
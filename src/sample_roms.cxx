@@ -1,4 +1,5 @@
 #include "sample.hxx"
+#include "cpu_meter.hxx"
 #include <inttypes.h>
 #ifndef PROGMEM
 #include "pgmspace.h"
@@ -235,14 +236,14 @@ struct TR909_CR_OR : public CHOH
 
 void init_sample_roms()
 {
-    machine::add<TR909_CH_OH>(machine::DRUM, "TR909-HiHat");
-    machine::add<TR909_CR_OR>(machine::DRUM, "TR909-Ride");
+    machine::add<Metered<TR909_CH_OH>>(machine::DRUM, "TR909-HiHat");
+    machine::add<Metered<TR909_CR_OR>>(machine::DRUM, "TR909-Ride");
 
-    machine::add<TR707>(machine::DRUM, "TR707");
-    machine::add<TR707_CH_OH>(machine::DRUM, "TR707-HiHat");
+    machine::add<Metered<TR707>>(machine::DRUM, "TR707");
+    machine::add<Metered<TR707_CH_OH>>(machine::DRUM, "TR707-HiHat");
 
 #ifndef PRIVATE
-    machine::add<Am6070Engine>(machine::DRUM, "Vint.EPROMs");
-    machine::add<CH_OH>(machine::DRUM, "Vint.HiHats");
+    machine::add<Metered<Am6070Engine>>(machine::DRUM, "Vint.EPROMs");
+    machine::add<Metered<CH_OH>>(machine::DRUM, "Vint.HiHats");
 #endif
 }
\ No newline at end of file
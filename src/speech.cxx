@@ -4,6 +4,7 @@
 #include "stmlib/stmlib.h"
 #include "stmlib/dsp/units.h"
 #include "machine.h"
+#include "cpu_meter.hxx"
 
 using namespace machine;
 
@@ -103,7 +104,7 @@ struct SpeechEngine : public Engine
 
 void init_speech()
 {
-    machine::add<SpeechEngine>("SPEECH", "LPC");
+    machine::add<Metered<SpeechEngine>>("SPEECH", "LPC");
 }
 
 MACHINE_INIT(init_speech);
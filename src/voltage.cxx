@@ -25,6 +25,8 @@
 //
 
 #include "machine.h"
+#include "cpu_meter.hxx"
+#include "output_conversion.hxx"
 
 using namespace machine;
 
@@ -34,6 +36,7 @@ class VoltsPerOctave : public Engine
     uint8_t note = DEFAULT_NOTE;
     uint8_t tune = 32;
     int32_t cv = 0;
+    float buffer[FRAME_BUFFER_SIZE];
 
 public:
     VoltsPerOctave() : Engine(OUT_EQ_VOLT | VOCT_INPUT)
@@ -48,7 +51,8 @@ public:
              (((int)note - DEFAULT_NOTE) * machine::PITCH_PER_OCTAVE / 12) +
              (((int)tune - 32) << 3);
 
-        of.push(&cv, 1);
+        output_conversion::fill(buffer, cv * output_conversion::kInt32VoltsPerLsb);
+        of.out = buffer;
     }
 
     void onDisplay(uint8_t *display) override
@@ -65,7 +69,7 @@ public:
 
 void init_voltage()
 {
-    machine::add<VoltsPerOctave>(CV, "V/OCT");
+    machine::add<Metered<VoltsPerOctave>>(CV, "V/OCT");
 }
 
 MACHINE_INIT(init_voltage);
\ No newline at end of file
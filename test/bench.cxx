@@ -0,0 +1,110 @@
+#include "host.hxx"
+
+#include <algorithm>
+#include <chrono>
+
+#include "stmlib/utils/random.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycles() { return __rdtsc(); }
+#else
+static inline uint64_t cycles() { return 0; }
+#endif
+
+// Times Engine::process() per FRAME_BUFFER_SIZE block for every registry entry
+// and prints a tab separated table (one row per engine) to stdout.
+//
+// usage: bench.exe [engine-filter] [blocks]
+
+constexpr double BLOCK_BUDGET_NS = 1e9 * machine::FRAME_BUFFER_SIZE / machine::SAMPLE_RATE;
+
+struct BlockTiming
+{
+    uint64_t ns;
+    uint64_t cycles;
+};
+
+template <typename T>
+static T percentile(std::vector<T> &v, float p)
+{
+    size_t i = std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5f));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    const int blocks = argc > 2 ? atoi(argv[2]) : 4000;
+    const int warmup = 64;
+
+    init_machines();
+
+    for (int k = 0; k < machine::FRAME_BUFFER_SIZE; k++)
+    {
+        machine::audio_in[0][k] = stmlib::Random::GetFloat() * 2 - 1;
+        machine::audio_in[1][k] = stmlib::Random::GetFloat() * 2 - 1;
+    }
+
+    printf("#\tmachine\tengine\tmin_ns\tmedian_ns\tp99_ns\tmax_ns\tmedian_cycles\tbudget_%%\n");
+
+    for (size_t j = 0; j < machine::registry.size(); j++)
+    {
+        auto &r = machine::registry[j];
+
+        if (filter != nullptr && strstr(r.engine, filter) == nullptr)
+            continue;
+
+        std::srand(0);
+        auto engine = r.init();
+
+        std::vector<uint64_t> ns;
+        std::vector<uint64_t> cy;
+        ns.reserve(blocks);
+        cy.reserve(blocks);
+
+        machine::ControlFrame frame;
+        const int trig_blocks = machine::SAMPLE_RATE / 6 / machine::FRAME_BUFFER_SIZE;
+
+        for (int b = -warmup; b < blocks; b++)
+        {
+            frame.trigger = ((b + warmup) % trig_blocks) == 0;
+            frame.gate = false;
+            frame.accent = false;
+            frame.cv_voltage_ = 0;
+            frame.clock = 0;
+
+            machine::OutputFrame of;
+
+            auto c0 = cycles();
+            auto t0 = std::chrono::steady_clock::now();
+            engine->process(frame, of);
+            auto t1 = std::chrono::steady_clock::now();
+            auto c1 = cycles();
+
+            frame.t++;
+
+            if (b < 0)
+                continue;
+
+            ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            cy.push_back(c1 - c0);
+        }
+
+        free(engine);
+
+        auto min_ns = *std::min_element(ns.begin(), ns.end());
+        auto max_ns = *std::max_element(ns.begin(), ns.end());
+        auto median_ns = percentile(ns, 0.5f);
+        auto p99_ns = percentile(ns, 0.99f);
+        auto median_cy = percentile(cy, 0.5f);
+
+        printf("%d\t%s\t%s\t%llu\t%llu\t%llu\t%llu\t%llu\t%.2f\n", (int)j, r.machine, r.engine,
+               (unsigned long long)min_ns, (unsigned long long)median_ns,
+               (unsigned long long)p99_ns, (unsigned long long)max_ns,
+               (unsigned long long)median_cy, 100.0 * median_ns / BLOCK_BUDGET_NS);
+    }
+
+    return 0;
+}
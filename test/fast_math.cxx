@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "fast_math.hxx"
+
+// Max error of the fast_math functions against double precision libm over their
+// documented range, and ns per call of fast_math vs. the float libm function.
+//
+// usage: fast_math.exe [points]
+
+static volatile float sink;
+
+// ns per call in a loop the compiler can inline, like an engine's inner loop.
+template <class F>
+static double time_ns(F f, const std::vector<float> &x)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    float acc = 0;
+    for (int rep = 0; rep < 10; rep++)
+        for (float v : x)
+            acc += f(v);
+    auto t1 = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (10.0 * x.size());
+}
+
+template <class Fast, class Libm, class Exact>
+static void report(const char *name, float from, float to, bool relative, int points, Fast fast, Libm libm, Exact exact)
+{
+    std::vector<float> x(points);
+    double max_error = 0;
+    float worst = from;
+
+    for (int i = 0; i < points; i++)
+    {
+        x[i] = from + (to - from) * i / (points - 1);
+        double e = exact((double)x[i]);
+        double error = std::fabs(fast(x[i]) - e);
+        if (relative)
+            error /= std::fabs(e);
+
+        if (error > max_error)
+        {
+            max_error = error;
+            worst = x[i];
+        }
+    }
+
+    printf("%s\t[%g, %g]\t%s\t%.2e\t%g\t%.2f\t%.2f\n", name, from, to, relative ? "rel" : "abs", max_error, worst,
+           time_ns(fast, x), time_ns(libm, x));
+}
+
+int main(int argc, char **argv)
+{
+    const int points = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    printf("function\trange\terror\tmax_error\tat\tfast_ns\tlibm_ns\n");
+
+    report("sin", -1000, 1000, false, points, [](float x) { return fast_math::sin(x); },
+           [](float x) { return sinf(x); }, [](double x) { return std::sin(x); });
+    report("cos", -1000, 1000, false, points, [](float x) { return fast_math::cos(x); },
+           [](float x) { return cosf(x); }, [](double x) { return std::cos(x); });
+
+    return 0;
+}
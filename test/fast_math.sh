@@ -0,0 +1,9 @@
+cd $(dirname $0)
+
+mkdir -p ../.test
+set -ex
+
+g++ -O2 -g -m64 -I ../lib/ -I ../src/ -D TEST -D_GLIBCXX_USE_C99 ./fast_math.cxx -o ../.test/fast_math.exe
+
+cd ../.test
+./fast_math.exe "$@"
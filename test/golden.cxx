@@ -0,0 +1,220 @@
+#include "host.hxx"
+
+#include <cmath>
+#include <sys/stat.h>
+
+#include "stmlib/utils/random.h"
+
+// Golden output regression test. Every registry entry is rendered with fixed
+// seeds (stmlib::Random, std::rand) - triggers, a parameter sweep and a noise
+// signal on the audio inputs - and the float out/aux samples are compared
+// against the reference:
+//
+//  bit-exact (default) - FNV-1a hash of the samples vs. test/golden/hashes.txt
+//  --snr <dB>          - engines that are not bit-exact pass if the SNR vs.
+//                        <ref>/<machine>_<engine>.f32 is high enough, for
+//                        optimizations that change the rounding
+//
+// The hashes are committed and checked by CI. The host output depends on the
+// compiler, libm and libmachine, so CI builds in the gcc:12.2.0 image the hashes
+// were made with. --update rewrites the hashes - for a toolchain bump or an
+// intended change of the output - and writes the float32 files of the current
+// tree to <ref> (default .test/golden, not committed) for --snr.
+//
+// usage: golden.exe [--update] [--snr <dB>] [--ref <dir>] [--hashes <file>] [engine-filter]
+
+constexpr int kBlocks = 4 * machine::SAMPLE_RATE / machine::FRAME_BUFFER_SIZE;
+constexpr int kTriggerBlocks = machine::SAMPLE_RATE / 6 / machine::FRAME_BUFFER_SIZE;
+constexpr int kSweepBlocks = kBlocks / 8;
+
+static std::vector<float> render(machine::EngineDef &r)
+{
+    stmlib::Random::Seed(0x21);
+    std::srand(0);
+
+    auto engine = r.init();
+    std::vector<float> samples;
+    samples.reserve(kBlocks * machine::FRAME_BUFFER_SIZE * 2);
+
+    int num_params = 0;
+    while (num_params < (int)LEN_OF(engine->param) && engine->param[num_params].name != nullptr)
+        num_params++;
+
+    machine::ControlFrame frame;
+
+    for (int b = 0; b < kBlocks; b++)
+    {
+        if (b > 0 && (b % kSweepBlocks) == 0 && num_params > 0)
+        {
+            auto &p = engine->param[(b / kSweepBlocks) % num_params];
+            p.from_uint16(stmlib::Random::GetWord() >> 16);
+        }
+
+        for (int k = 0; k < machine::FRAME_BUFFER_SIZE; k++)
+        {
+            float env = 1.f - (float)(b % kTriggerBlocks) / kTriggerBlocks;
+            machine::audio_in[0][k] = (stmlib::Random::GetFloat() * 2 - 1) * env * env;
+            machine::audio_in[1][k] = (stmlib::Random::GetFloat() * 2 - 1) * env * env;
+        }
+
+        frame.trigger = (b % kTriggerBlocks) == 0;
+        frame.accent = (b % (kTriggerBlocks * 4)) == 0;
+        frame.gate = (b % kTriggerBlocks) < kTriggerBlocks / 2;
+        frame.cv_voltage_ = ((b / kTriggerBlocks) % 5) * machine::PITCH_PER_OCTAVE / 12;
+
+        machine::OutputFrame of;
+        engine->process(frame, of);
+        frame.t++;
+
+        for (int k = 0; k < machine::FRAME_BUFFER_SIZE; k++)
+        {
+            samples.push_back(of.out != nullptr ? of.out[k] : 0);
+            samples.push_back(of.aux != nullptr ? of.aux[k] : 0);
+        }
+    }
+
+    machine::free(engine);
+    return samples;
+}
+
+static uint64_t fnv1a(const std::vector<float> &samples)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto bytes = reinterpret_cast<const uint8_t *>(samples.data());
+    for (size_t i = 0; i < samples.size() * sizeof(float); i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+static std::string ref_file(const std::string &dir, const machine::EngineDef &r)
+{
+    std::string name = std::string(r.machine) + "_" + r.engine;
+    for (auto &c : name)
+        if (!isalnum(c) && c != '-' && c != '.')
+            c = '_';
+    return dir + "/" + name + ".f32";
+}
+
+int main(int argc, char **argv)
+{
+    bool update = false;
+    float min_snr = 0;
+    std::string ref_dir = "golden";
+    std::string golden = "../test/golden/hashes.txt";
+    const char *filter = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--update"))
+            update = true;
+        else if (!strcmp(argv[i], "--snr") && i + 1 < argc)
+            min_snr = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ref") && i + 1 < argc)
+            ref_dir = argv[++i];
+        else if (!strcmp(argv[i], "--hashes") && i + 1 < argc)
+            golden = argv[++i];
+        else
+            filter = argv[i];
+    }
+
+    init_machines();
+
+    std::map<std::string, uint64_t> hashes;
+    {
+        std::ifstream in(golden);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            auto tab = line.find('\t');
+            if (tab != std::string::npos)
+                hashes[line.substr(tab + 1)] = strtoull(line.c_str(), nullptr, 16);
+        }
+    }
+
+    if (update)
+        mkdir(ref_dir.c_str(), 0755);
+
+    int failed = 0;
+
+    printf("#\tmachine\tengine\tresult\tsnr_db\tmax_diff\n");
+
+    for (size_t j = 0; j < machine::registry.size(); j++)
+    {
+        auto &r = machine::registry[j];
+
+        if (filter != nullptr && strstr(r.engine, filter) == nullptr)
+            continue;
+
+        auto samples = render(r);
+        auto hash = fnv1a(samples);
+        auto key = std::string(r.machine) + "/" + r.engine;
+
+        if (update)
+        {
+            hashes[key] = hash;
+            std::ofstream out(ref_file(ref_dir, r), std::ios::binary);
+            out.write(reinterpret_cast<const char *>(samples.data()), samples.size() * sizeof(float));
+            printf("%d\t%s\t%s\tupdated\n", (int)j, r.machine, r.engine);
+            continue;
+        }
+
+        auto it = hashes.find(key);
+        const char *result = it == hashes.end() ? "missing" : it->second == hash ? "exact" : "differs";
+
+        if (it != hashes.end() && it->second == hash)
+        {
+            printf("%d\t%s\t%s\t%s\n", (int)j, r.machine, r.engine, result);
+            continue;
+        }
+
+        if (min_snr <= 0)
+        {
+            printf("%d\t%s\t%s\t%s\n", (int)j, r.machine, r.engine, result);
+            failed++;
+            continue;
+        }
+
+        std::vector<float> ref(samples.size());
+        std::ifstream in(ref_file(ref_dir, r), std::ios::binary);
+        if (!in.read(reinterpret_cast<char *>(ref.data()), ref.size() * sizeof(float)))
+        {
+            printf("%d\t%s\t%s\tno reference\n", (int)j, r.machine, r.engine);
+            failed++;
+            continue;
+        }
+
+        double signal = 0;
+        double noise = 0;
+        float max_diff = 0;
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            float d = samples[i] - ref[i];
+            signal += (double)ref[i] * ref[i];
+            noise += (double)d * d;
+            max_diff = std::max(max_diff, std::fabs(d));
+        }
+
+        double snr = noise > 0 ? 10 * log10(signal / noise) : INFINITY;
+        bool pass = snr >= min_snr;
+        failed += !pass;
+
+        printf("%d\t%s\t%s\t%s\t%.1f\t%g\n", (int)j, r.machine, r.engine, pass ? "snr" : "FAILED", snr, max_diff);
+    }
+
+    if (update)
+    {
+        std::ofstream out(golden);
+        for (auto &h : hashes)
+        {
+            char tmp[17];
+            sprintf(tmp, "%016llx", (unsigned long long)h.second);
+            out << tmp << '\t' << h.first << '\n';
+        }
+        return 0;
+    }
+
+    if (failed)
+        printf("# %d engine(s) failed\n", failed);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+cd $(dirname $0)
+
+mkdir -p ../.test
+INC=$(for i in ../.pio/libdeps/*/*/; do echo "-I $i"; done )
+FILTER="fv1|marbles|main|EEPROM|SPI|machine|hemisphere|test"
+SRC=$(find -L ../src/ ../lib/ -name "*.cc" -o -name "*.cxx" -o -name "*.cpp" | grep -v -E "$FILTER" )
+set -ex
+
+g++ -O2 -g -m64 -I ../lib/ -I ../lib/machine/include/ -I ../src/ -I ../.pio/libdeps/*/libmachine*/ $INC -D TEST -DFLASHMEM="" -DPROGMEM="" -DVERSION="\"0\"" \
+    -Wformat=0 -fpermissive -Wnarrowing -D_GLIBCXX_USE_C99 ./golden.cxx $SRC -o ../.test/golden.exe
+
+cd ../.test
+./golden.exe "$@"
@@ -0,0 +1,104 @@
+#include "host.hxx"
+#include "machine_arena.hxx"
+
+#include <malloc.h>
+
+#include "stmlib/utils/random.h"
+
+// Prints the RAM cost of every registry entry as a tab separated table:
+//  object  - sizeof the engine (what machine::malloc was asked for)
+//  buffers - machine_arena::Buffer bytes held after the warmup
+//  heap    - bytes taken from the heap by the engine itself (new/malloc),
+//            incl. the allocator's chunk overhead
+//  total   - object + buffers + heap, compared against MACHINE_TRACK_BUDGET,
+//            the device heap divided by the tracks
+//
+// Returns 1 if the total of a machine exceeds the budget - four such machines
+// would over-commit the device. The exempt machines below are reported, but
+// don't fail: they can't be loaded on every track at the same time.
+//
+// usage: memory.exe [engine-filter] [blocks]
+
+// Delay keeps 1s of 16 bit stereo, as before the lazy buffers - Delay-uLaw is
+// the variant that fits every track.
+static const char *exempt[] = {"Delay"};
+
+int main(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    const int blocks = argc > 2 ? atoi(argv[2]) : 2000;
+
+    mallopt(M_MMAP_MAX, 0); // large blocks stay on the heap counted by mallinfo2()
+
+    init_machines();
+
+    for (int k = 0; k < machine::FRAME_BUFFER_SIZE; k++)
+    {
+        machine::audio_in[0][k] = stmlib::Random::GetFloat() * 2 - 1;
+        machine::audio_in[1][k] = stmlib::Random::GetFloat() * 2 - 1;
+    }
+
+    int over_budget = 0;
+
+    printf("#\tmachine\tengine\tobject\tbuffers\theap\ttotal\tbudget_%%\n");
+
+    for (size_t j = 0; j < machine::registry.size(); j++)
+    {
+        auto &r = machine::registry[j];
+
+        if (filter != nullptr && strstr(r.engine, filter) == nullptr)
+            continue;
+
+        std::srand(0);
+
+        size_t buffers0 = machine_arena::held();
+        size_t heap0 = mallinfo2().uordblks;
+
+        auto engine = r.init();
+        size_t object = machine::alloc_stats.last;
+
+        machine::ControlFrame frame;
+        const int trig_blocks = machine::SAMPLE_RATE / 6 / machine::FRAME_BUFFER_SIZE;
+
+        for (int b = 0; b < blocks; b++)
+        {
+            frame.trigger = (b % trig_blocks) == 0;
+            machine::OutputFrame of;
+            engine->process(frame, of);
+            frame.t++;
+        }
+
+        size_t buffers = machine_arena::held() - buffers0;
+        size_t heap = mallinfo2().uordblks - heap0;
+        heap -= std::min(heap, object + buffers);
+
+        size_t total = object + buffers + heap;
+        float load = 100.f * total / MACHINE_TRACK_BUDGET;
+        const char *note = "";
+
+        bool is_exempt = false;
+        for (auto name : exempt)
+            is_exempt |= !strcmp(r.engine, name);
+
+        if (total > MACHINE_TRACK_BUDGET)
+        {
+            if (is_exempt)
+                note = "\tnot on all tracks (exempt)";
+            else
+            {
+                note = "\tOVER BUDGET";
+                over_budget++;
+            }
+        }
+
+        free(engine);
+
+        printf("%d\t%s\t%s\t%zu\t%zu\t%zu\t%zu\t%.1f%s\n", (int)j, r.machine, r.engine,
+               object, buffers, heap, total, load, note);
+    }
+
+    printf("# budget per track: %d bytes (heap %d bytes / %d tracks)\n",
+           MACHINE_TRACK_BUDGET, MACHINE_HEAP_SIZE, MACHINE_TRACKS);
+
+    return over_budget > 0 ? 1 : 0;
+}
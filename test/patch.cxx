@@ -0,0 +1,494 @@
+#include "host.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+// Offline patch simulator - renders up to four tracks block by block, the way
+// the firmware runs them, and writes one stereo WAV (out/aux) per track plus a
+// tab separated timing table to stdout. Build with -g and run it under perf to
+// profile a live patch.
+//
+// usage: patch.exe <patch-file> [output-prefix]
+//
+// Patch file, one statement per line, '#' starts a comment:
+//
+//   length <seconds>
+//   track <n> <machine>/<engine>          e.g. "track 1 M-OSC/Waveforms"
+//   param <n> <name|index> <0..1>         knob position, like Parameter::from_uint16
+//   trig <n> <file>|every <seconds>       trigger events, a value > 1 is an accent
+//   gate <n> <file>                       gate, high while the value is > 0
+//   cv <n> <file>                         V/OCT input in volts
+//   mod <n> <name|index> cv<k> <amount>   Parameter::modulate(cv input k * amount)
+//   cvin <k> <file>                       CV input k (machine::get_cv)
+//   trigin <k> <file>|every <seconds>     trigger input k (machine::get_trigger)
+//   in <L|R> <file.wav>                   audio input, 16 bit PCM (first channel)
+//   route <n> <L|R> <source>              track audio input: in.L, in.R, <m>.out, <m>.aux
+//
+// Event files hold "<seconds> [value]" lines, a missing value is 1. Values are
+// held until the next event. Tracks run in the order 1..4 within a block, a
+// route from a later track gets its output of the previous block.
+
+constexpr int kNumTracks = 4;
+constexpr int kNumInputs = 4;
+constexpr double kBlockSeconds = (double)machine::FRAME_BUFFER_SIZE / machine::SAMPLE_RATE;
+constexpr double BLOCK_BUDGET_NS = 1e9 * kBlockSeconds;
+
+struct Stream
+{
+    std::vector<std::pair<double, float>> events;
+    double every = 0;
+    size_t pos = 0;
+    float value = 0;
+
+    // Applies the events of the block [t0, t1) - true if there was one.
+    bool advance(double t0, double t1)
+    {
+        if (every > 0)
+        {
+            value = 1;
+            return std::ceil(t0 / every) * every < t1;
+        }
+
+        bool event = false;
+        while (pos < events.size() && events[pos].first < t1)
+        {
+            value = events[pos++].second;
+            event = true;
+        }
+        return event;
+    }
+};
+
+struct Modulation
+{
+    machine::Parameter *param;
+    int cv;
+    float amount;
+};
+
+struct Route
+{
+    int track; // -1: global audio input
+    int channel;
+};
+
+struct Track
+{
+    const machine::EngineDef *def = nullptr;
+    machine::Engine *engine = nullptr;
+
+    Stream trig;
+    Stream gate;
+    Stream cv;
+    std::vector<Modulation> mods;
+    Route route[2] = {{-1, 0}, {-1, 1}};
+
+    float out[2][machine::FRAME_BUFFER_SIZE] = {};
+    std::vector<int16_t> wav;
+    std::vector<uint64_t> ns;
+};
+
+static std::string base_dir;
+
+static std::string resolve(const std::string &path)
+{
+    return path.empty() || path[0] == '/' ? path : base_dir + path;
+}
+
+static bool fail(int line, const std::string &msg)
+{
+    fprintf(stderr, "patch:%d: %s\n", line, msg.c_str());
+    return false;
+}
+
+static bool load_stream(std::istringstream &args, Stream &stream)
+{
+    std::string file;
+    args >> file;
+
+    if (file == "every")
+        return (bool)(args >> stream.every) && stream.every > 0;
+
+    std::ifstream in(resolve(file));
+    if (!in)
+        return false;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream ev(line.substr(0, line.find('#')));
+        double t;
+        float v = 1;
+        if (ev >> t)
+        {
+            ev >> v;
+            stream.events.push_back({t, v});
+        }
+    }
+
+    std::stable_sort(stream.events.begin(), stream.events.end(),
+                     [](const std::pair<double, float> &a, const std::pair<double, float> &b)
+                     { return a.first < b.first; });
+    return true;
+}
+
+static std::vector<float> read_wav(const std::string &fileName)
+{
+    std::vector<float> samples;
+    std::ifstream in(fileName, std::ios::binary);
+
+    char riff[12];
+    if (!in.read(riff, sizeof(riff)) || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4))
+        return samples;
+
+    uint16_t channels = 1;
+    uint16_t bits = 16;
+    char id[4];
+    uint32_t size;
+
+    while (in.read(id, 4) && in.read(reinterpret_cast<char *>(&size), 4))
+    {
+        if (!memcmp(id, "fmt ", 4))
+        {
+            std::vector<char> fmt(size);
+            in.read(fmt.data(), size);
+            memcpy(&channels, &fmt[2], 2);
+            memcpy(&bits, &fmt[14], 2);
+        }
+        else if (!memcmp(id, "data", 4) && bits == 16)
+        {
+            std::vector<int16_t> pcm(size / 2);
+            in.read(reinterpret_cast<char *>(pcm.data()), pcm.size() * 2);
+            for (size_t i = 0; i < pcm.size(); i += channels)
+                samples.push_back(pcm[i] / 32768.f);
+            break;
+        }
+        else
+            in.seekg(size + (size & 1), std::ios::cur);
+    }
+
+    return samples;
+}
+
+static machine::Parameter *find_param(Track &track, const std::string &name)
+{
+    auto &param = track.engine->param;
+
+    if (!name.empty() && std::all_of(name.begin(), name.end(), ::isdigit))
+    {
+        size_t i = atoi(name.c_str());
+        return i < LEN_OF(param) && param[i].name != nullptr ? &param[i] : nullptr;
+    }
+
+    for (size_t i = 0; i < LEN_OF(param) && param[i].name != nullptr; i++)
+        if (name == param[i].name)
+            return &param[i];
+
+    return nullptr;
+}
+
+static bool parse_route(const std::string &src, Route &route)
+{
+    if (src == "in.L" || src == "in.R")
+    {
+        route = {-1, src == "in.L" ? 0 : 1};
+        return true;
+    }
+
+    int n = 0;
+    char channel[8] = {};
+    if (sscanf(src.c_str(), "%d.%7s", &n, channel) != 2 || n < 1 || n > kNumTracks)
+        return false;
+
+    if (strcmp(channel, "out") && strcmp(channel, "aux"))
+        return false;
+
+    route = {n - 1, strcmp(channel, "out") ? 1 : 0};
+    return true;
+}
+
+static bool load_patch(const char *path, Track *tracks, Stream *cvin, Stream *trigin,
+                       std::vector<float> *audio, double &length)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    std::string line;
+    for (int n = 1; std::getline(in, line); n++)
+    {
+        std::istringstream args(line.substr(0, line.find('#')));
+        std::string cmd;
+        if (!(args >> cmd))
+            continue;
+
+        if (cmd == "length")
+        {
+            if (!(args >> length))
+                return fail(n, "length <seconds>");
+            continue;
+        }
+
+        if (cmd == "cvin" || cmd == "trigin")
+        {
+            int k = -1;
+            args >> k;
+            if (k < 0 || k >= kNumInputs)
+                return fail(n, "input index out of range");
+            if (!load_stream(args, cmd == "cvin" ? cvin[k] : trigin[k]))
+                return fail(n, "can't load " + cmd + " stream");
+            continue;
+        }
+
+        if (cmd == "in")
+        {
+            std::string channel, file;
+            args >> channel >> file;
+            if (channel != "L" && channel != "R")
+                return fail(n, "in <L|R> <file.wav>");
+            audio[channel == "L" ? 0 : 1] = read_wav(resolve(file));
+            if (audio[channel == "L" ? 0 : 1].empty())
+                return fail(n, "can't read " + file);
+            continue;
+        }
+
+        int t = 0;
+        args >> t;
+        if (t < 1 || t > kNumTracks)
+            return fail(n, "track number out of range");
+
+        auto &track = tracks[t - 1];
+
+        if (cmd == "track")
+        {
+            std::string name;
+            std::getline(args >> std::ws, name);
+            auto sep = name.find('/');
+
+            for (auto &r : machine::registry)
+                if (sep != std::string::npos && name.compare(0, sep, r.machine) == 0 &&
+                    name.compare(sep + 1, std::string::npos, r.engine) == 0)
+                    track.def = &r;
+
+            if (track.def == nullptr)
+                return fail(n, "unknown engine " + name);
+
+            if (track.engine != nullptr)
+                machine::free(track.engine);
+            track.engine = track.def->init();
+            continue;
+        }
+
+        if (cmd == "trig" || cmd == "gate" || cmd == "cv")
+        {
+            auto &stream = cmd == "trig" ? track.trig : cmd == "gate" ? track.gate : track.cv;
+            if (!load_stream(args, stream))
+                return fail(n, "can't load " + cmd + " stream");
+            continue;
+        }
+
+        if (cmd == "route")
+        {
+            std::string channel, src;
+            args >> channel >> src;
+            if ((channel != "L" && channel != "R") || !parse_route(src, track.route[channel == "L" ? 0 : 1]))
+                return fail(n, "route <n> <L|R> <in.L|in.R|<m>.out|<m>.aux>");
+            continue;
+        }
+
+        if (track.engine == nullptr)
+            return fail(n, "track " + std::to_string(t) + " has no engine");
+
+        if (cmd == "param")
+        {
+            std::string name;
+            float value = 0;
+            args >> name >> value;
+            auto param = find_param(track, name);
+            if (param == nullptr)
+                return fail(n, "unknown parameter " + name);
+            param->from_uint16(std::max(0.f, std::min(1.f, value)) * UINT16_MAX);
+            continue;
+        }
+
+        if (cmd == "mod")
+        {
+            std::string name;
+            Modulation mod = {nullptr, -1, 0};
+            args >> name;
+            mod.param = find_param(track, name);
+            if (mod.param == nullptr)
+                return fail(n, "unknown parameter " + name);
+            if (!(args >> name >> mod.amount) || sscanf(name.c_str(), "cv%d", &mod.cv) != 1 ||
+                mod.cv < 0 || mod.cv >= kNumInputs)
+                return fail(n, "mod <n> <param> cv<k> <amount>");
+            track.mods.push_back(mod);
+            continue;
+        }
+
+        return fail(n, "unknown statement " + cmd);
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <patch-file> [output-prefix]\n", argv[0]);
+        return 1;
+    }
+
+    std::string prefix = argc > 2 ? argv[2] : "";
+    base_dir = argv[1];
+    base_dir = base_dir.substr(0, base_dir.rfind('/') + 1);
+
+    init_machines();
+
+    Track tracks[kNumTracks];
+    Stream cvin[kNumInputs];
+    Stream trigin[kNumInputs];
+    std::vector<float> audio[2];
+    double length = 10;
+
+    if (!load_patch(argv[1], tracks, cvin, trigin, audio, length))
+        return 1;
+
+    const int blocks = (int)(length / kBlockSeconds);
+    machine::ControlFrame frame;
+    std::vector<uint64_t> total_ns;
+    total_ns.reserve(blocks);
+
+    for (auto &track : tracks)
+    {
+        track.wav.reserve(blocks * machine::FRAME_BUFFER_SIZE * 2);
+        track.ns.reserve(blocks);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int b = 0; b < blocks; b++)
+    {
+        double t0 = b * kBlockSeconds;
+        double t1 = t0 + kBlockSeconds;
+
+        machine::digital_inputs = 0;
+        for (int k = 0; k < kNumInputs; k++)
+        {
+            if (trigin[k].advance(t0, t1) && trigin[k].value > 0)
+                machine::digital_inputs |= 1 << k;
+
+            cvin[k].advance(t0, t1);
+            machine::cv_voltage[k] = cvin[k].value;
+        }
+
+        float input[2][machine::FRAME_BUFFER_SIZE] = {};
+        for (int c = 0; c < 2; c++)
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+            {
+                size_t s = (size_t)b * machine::FRAME_BUFFER_SIZE + i;
+                input[c][i] = s < audio[c].size() ? audio[c][s] : 0;
+            }
+
+        uint64_t block_ns = 0;
+
+        for (auto &track : tracks)
+        {
+            if (track.engine == nullptr)
+                continue;
+
+            frame.trigger = track.trig.advance(t0, t1) && track.trig.value > 0;
+            frame.accent = frame.trigger && track.trig.value > 1;
+            track.gate.advance(t0, t1);
+            frame.gate = track.gate.value > 0;
+            track.cv.advance(t0, t1);
+            frame.cv_voltage_ = track.cv.value * machine::PITCH_PER_OCTAVE;
+
+            for (int c = 0; c < 2; c++)
+            {
+                auto &route = track.route[c];
+                auto src = route.track < 0 ? input[route.channel] : tracks[route.track].out[route.channel];
+                std::copy(src, src + machine::FRAME_BUFFER_SIZE, machine::audio_in[c]);
+            }
+
+            for (auto &mod : track.mods)
+                mod.param->modulate(cvin[mod.cv].value * mod.amount);
+
+            machine::OutputFrame of;
+
+            auto c0 = std::chrono::steady_clock::now();
+            track.engine->process(frame, of);
+            auto c1 = std::chrono::steady_clock::now();
+
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count();
+            track.ns.push_back(ns);
+            block_ns += ns;
+
+            const float *outs[2] = {of.out, of.aux};
+            for (int c = 0; c < 2; c++)
+            {
+                if (outs[c] != nullptr)
+                    std::copy(outs[c], outs[c] + machine::FRAME_BUFFER_SIZE, track.out[c]);
+                else
+                    std::fill(track.out[c], track.out[c] + machine::FRAME_BUFFER_SIZE, 0.f);
+            }
+
+            // Same scaling as test.cxx.
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                for (int c = 0; c < 2; c++)
+                {
+                    auto v = (-track.out[c][i]) * INT16_MAX;
+                    CONSTRAIN(v, INT16_MIN, INT16_MAX);
+                    track.wav.push_back(v);
+                }
+        }
+
+        total_ns.push_back(block_ns);
+        frame.t++;
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto percentile = [](std::vector<uint64_t> v, float p)
+    {
+        size_t i = std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5f));
+        std::nth_element(v.begin(), v.begin() + i, v.end());
+        return (unsigned long long)v[i];
+    };
+
+    printf("track\tmachine\tengine\tmedian_ns\tp99_ns\tmax_ns\tbudget_%%\n");
+
+    for (int i = 0; i < kNumTracks; i++)
+    {
+        auto &track = tracks[i];
+        if (track.engine == nullptr || track.ns.empty())
+            continue;
+
+        auto median = percentile(track.ns, 0.5f);
+        printf("%d\t%s\t%s\t%llu\t%llu\t%llu\t%.2f\n", i + 1, track.def->machine, track.def->engine, median,
+               percentile(track.ns, 0.99f), percentile(track.ns, 1.f), 100.0 * median / BLOCK_BUDGET_NS);
+
+        write_wav(track.wav, prefix + "track" + std::to_string(i + 1) + ".wav", 2);
+        machine::free(track.engine);
+    }
+
+    if (total_ns.empty())
+        return 0;
+
+    auto overruns = std::count_if(total_ns.begin(), total_ns.end(), [](uint64_t ns)
+                                  { return ns > BLOCK_BUDGET_NS; });
+    auto median = percentile(total_ns, 0.5f);
+
+    printf("all\t\t\t%llu\t%llu\t%llu\t%.2f\n", median, percentile(total_ns, 0.99f),
+           percentile(total_ns, 1.f), 100.0 * median / BLOCK_BUDGET_NS);
+    printf("# %.1f s rendered in %.2f s (%.1fx real time), %d of %d blocks over budget\n", length, wall,
+           length / wall, (int)overruns, blocks);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "host.hxx"
+
+#include <cmath>
+
+// Pitch check for a full rate and a half rate (decimation=2) oscillator engine.
+// The half rate one needs its note raised by an octave. Each engine is
+// triggered at DEFAULT_NOTE, and the strongest spectral peak between 2.3
+// octaves below and a fifth above the expected frequency is taken as the
+// fundamental. Exits with 1 if an engine is off by more than kMaxCents.
+// The engines are chosen for a harmonic spectrum - Modal for example is tuned
+// a semitone low by design.
+//
+// usage: pitch.exe [engine-filter]
+
+constexpr float kMaxCents = 20;
+constexpr int kSkip = machine::SAMPLE_RATE / 20;
+constexpr int kWindow = machine::SAMPLE_RATE / 4;
+
+static const char *engines[] = {"Waveshaping", "String"};
+
+static std::vector<float> render(machine::EngineDef &r)
+{
+    std::srand(0);
+    auto engine = r.init();
+
+    std::vector<float> samples;
+    machine::ControlFrame frame;
+
+    while ((int)samples.size() < kSkip + kWindow)
+    {
+        frame.trigger = frame.t == 0;
+        frame.gate = true;
+
+        machine::OutputFrame of;
+        engine->process(frame, of);
+        frame.t++;
+
+        for (int k = 0; k < machine::FRAME_BUFFER_SIZE; k++)
+            samples.push_back(of.out != nullptr ? of.out[k] : 0);
+    }
+
+    machine::free(engine);
+    return std::vector<float>(samples.begin() + kSkip, samples.end());
+}
+
+static double magnitude(const std::vector<float> &x, double hz)
+{
+    double re = 0, im = 0;
+    double w = 2 * M_PI * hz / machine::SAMPLE_RATE;
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        double hann = 0.5 - 0.5 * cos(2 * M_PI * i / x.size());
+        re += hann * x[i] * cos(w * i);
+        im += hann * x[i] * sin(w * i);
+    }
+    return sqrt(re * re + im * im);
+}
+
+// Strongest peak in 1 cent steps, refined by parabolic interpolation.
+static float estimate_hz(const std::vector<float> &x, float expected)
+{
+    const int from = -2800;
+    const int to = 700;
+
+    std::vector<double> m;
+    for (int cents = from; cents <= to; cents++)
+        m.push_back(magnitude(x, expected * pow(2.0, cents / 1200.0)));
+
+    size_t best = 1;
+    for (size_t i = 1; i + 1 < m.size(); i++)
+        if (m[i] > m[best])
+            best = i;
+
+    double d = m[best - 1] - 2 * m[best] + m[best + 1];
+    double offset = d != 0 ? 0.5 * (m[best - 1] - m[best + 1]) / d : 0;
+    return expected * pow(2.0, (from + (int)best + offset) / 1200.0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+
+    init_machines();
+
+    const float expected = 440.f * powf(2.f, (machine::DEFAULT_NOTE - 69) / 12.f);
+    int failed = 0;
+
+    printf("#\tmachine\tengine\texpected_hz\thz\tcents\tresult\n");
+
+    for (size_t j = 0; j < machine::registry.size(); j++)
+    {
+        auto &r = machine::registry[j];
+
+        if (filter != nullptr && strstr(r.engine, filter) == nullptr)
+            continue;
+
+        bool listed = false;
+        for (auto name : engines)
+            listed |= !strcmp(r.engine, name);
+
+        if (!listed)
+            continue;
+
+        float hz = estimate_hz(render(r), expected);
+        float cents = hz > 0 ? 1200 * log2f(hz / expected) : INFINITY;
+        bool pass = fabsf(cents) <= kMaxCents;
+        failed += !pass;
+
+        printf("%d\t%s\t%s\t%.1f\t%.1f\t%.1f\t%s\n", (int)j, r.machine, r.engine, expected, hz, cents, pass ? "ok" : "FAILED");
+    }
+
+    if (failed)
+        printf("# %d engine(s) off pitch\n", failed);
+
+    return failed ? 1 : 0;
+}
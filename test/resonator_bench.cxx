@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "rings/dsp/resonator.h"
+#include "rings/resources.h"
+#include "stmlib/dsp/cosine_oscillator.h"
+#include "stmlib/dsp/parameter_interpolator.h"
+#include "stmlib/utils/random.h"
+
+// Compares rings::Resonator (struct of arrays mode bank) against the previous
+// one-Svf-per-mode implementation, kept below as the reference. Prints time
+// per FRAME_BUFFER_SIZE block and the difference of the two outputs, and exits
+// with 1 if any case is below kMinSnr. The high pitches clamp the upper
+// partials, which gives odd mode counts.
+//
+// usage: resonator_bench.exe [blocks]
+
+using namespace stmlib;
+
+constexpr size_t kBlockSize = 24;
+constexpr double kMinSnr = 100;
+
+struct ReferenceResonator
+{
+    float frequency_ = 220.0f / rings::kSampleRate;
+    float structure_ = 0.25f;
+    float brightness_ = 0.5f;
+    float position_ = 0.999f;
+    float previous_position_ = 0.0f;
+    float damping_ = 0.3f;
+    int32_t resolution_ = rings::kMaxModes;
+
+    Svf f_[rings::kMaxModes];
+
+    ReferenceResonator()
+    {
+        for (auto &f : f_)
+            f.Init();
+    }
+
+    int32_t ComputeFilters()
+    {
+        float stiffness = Interpolate(rings::lut_stiffness, structure_, 256.0f);
+        float harmonic = frequency_;
+        float stretch_factor = 1.0f;
+        float q = 500.0f * Interpolate(rings::lut_4_decades, damping_, 256.0f);
+        float brightness_attenuation = 1.0f - structure_;
+        brightness_attenuation *= brightness_attenuation;
+        brightness_attenuation *= brightness_attenuation;
+        brightness_attenuation *= brightness_attenuation;
+        float brightness = brightness_ * (1.0f - 0.2f * brightness_attenuation);
+        float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
+        float q_loss_damping_rate = structure_ * (2.0f - structure_) * 0.1f;
+        int32_t num_modes = 0;
+        for (int32_t i = 0; i < std::min(rings::kMaxModes, resolution_); ++i)
+        {
+            float partial_frequency = harmonic * stretch_factor;
+            if (partial_frequency >= 0.49f)
+                partial_frequency = 0.49f;
+            else
+                num_modes = i + 1;
+            f_[i].set_f_q<FREQUENCY_FAST>(partial_frequency, 1.0f + partial_frequency * q);
+            stretch_factor += stiffness;
+            stiffness *= stiffness < 0.0f ? 0.93f : 0.98f;
+            q_loss += q_loss_damping_rate * (1.0f - q_loss);
+            harmonic += frequency_;
+            q *= q_loss;
+        }
+        return num_modes;
+    }
+
+    void Process(const float *in, float *out, float *aux, size_t size)
+    {
+        int32_t num_modes = ComputeFilters();
+
+        ParameterInterpolator position(&previous_position_, position_, size);
+        while (size--)
+        {
+            CosineOscillator amplitudes;
+            amplitudes.Init<COSINE_OSCILLATOR_APPROXIMATE>(position.Next());
+
+            float input = *in++ * 0.125f;
+            float odd = 0.0f;
+            float even = 0.0f;
+            amplitudes.Start();
+            for (int32_t i = 0; i < num_modes;)
+            {
+                odd += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
+                even += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
+            }
+            *out++ = odd;
+            *aux++ = even;
+        }
+    }
+};
+
+template <typename T>
+static double run(T &r, int resolution, float hz, int blocks, std::vector<float> &result)
+{
+    r.resolution_ = resolution;
+    r.frequency_ = hz / rings::kSampleRate;
+    r.structure_ = 0.4f;
+    r.damping_ = 0.7f;
+
+    std::vector<float> in(kBlockSize);
+    std::vector<float> out(kBlockSize);
+    std::vector<float> aux(kBlockSize);
+    result.clear();
+
+    double ns = 0;
+    for (int b = 0; b < blocks; b++)
+    {
+        for (size_t i = 0; i < kBlockSize; i++)
+            in[i] = (b % 400) == 0 ? Random::GetFloat() * 2 - 1 : 0;
+
+        r.position_ = 0.5f + 0.45f * sinf(b * 0.001f);
+
+        auto t0 = std::chrono::steady_clock::now();
+        r.Process(in.data(), out.data(), aux.data(), kBlockSize);
+        auto t1 = std::chrono::steady_clock::now();
+        ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+        for (size_t i = 0; i < kBlockSize; i++)
+        {
+            result.push_back(out[i]);
+            result.push_back(aux[i]);
+        }
+    }
+    return ns / blocks;
+}
+
+// Exposes the settings of rings::Resonator under the reference member names.
+struct Resonator : rings::Resonator
+{
+    float frequency_, structure_, damping_, position_;
+    int32_t resolution_;
+
+    void Process(const float *in, float *out, float *aux, size_t size)
+    {
+        set_frequency(frequency_);
+        set_structure(structure_);
+        set_damping(damping_);
+        set_position(position_);
+        set_resolution(resolution_);
+        rings::Resonator::Process(in, out, aux, size);
+    }
+};
+
+int main(int argc, char **argv)
+{
+    const int blocks = argc > 1 ? atoi(argv[1]) : 20000;
+
+    struct Case
+    {
+        int resolution;
+        float hz;
+    };
+
+    const Case cases[] = {
+        {16, 110}, {24, 110}, {32, 110}, {48, 110}, {64, 110},
+        {64, 1000}, {64, 3000}, {64, 4300}, {64, 6500}, {16, 3500},
+    };
+
+    printf("resolution\thz\tmodes\treference_ns\tbank_ns\tspeedup\tsnr_db\n");
+
+    int failed = 0;
+
+    for (auto &c : cases)
+    {
+        auto reference = new ReferenceResonator();
+        auto bank = new Resonator();
+        bank->Init();
+
+        std::vector<float> a, b;
+        uint32_t seed = Random::state();
+        double reference_ns = run(*reference, c.resolution, c.hz, blocks, a);
+        Random::Seed(seed);
+        double bank_ns = run(*bank, c.resolution, c.hz, blocks, b);
+        int32_t modes = reference->ComputeFilters();
+
+        delete reference;
+        delete bank;
+
+        double signal = 0, error = 0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            signal += a[i] * a[i];
+            error += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+
+        // NaN (a blown up bank) fails as well.
+        double snr = error > 0 ? 10 * log10(signal / error) : INFINITY;
+        bool pass = snr >= kMinSnr;
+        failed += !pass;
+
+        printf("%d\t%.0f\t%d\t%.0f\t%.0f\t%.2f\t%.1f%s\n", c.resolution, c.hz, modes, reference_ns, bank_ns,
+               reference_ns / bank_ns, snr, pass ? "" : "\tFAILED");
+    }
+
+    if (failed)
+        printf("# %d case(s) below %.0f dB\n", failed, kMinSnr);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+cd $(dirname $0)
+
+mkdir -p ../.test
+SRC="../lib/rings/dsp/resonator.cc ../lib/rings/resources.cc ../lib/stmlib/utils/random.cc"
+set -ex
+
+g++ -O2 -g -m64 -I ../lib/ -D TEST -D_GLIBCXX_USE_C99 ./resonator_bench.cxx $SRC -o ../.test/resonator_bench.exe
+g++ -O2 -g -m64 -I ../lib/ -D TEST -D_GLIBCXX_USE_C99 -D STMLIB_SIMD_SCALAR ./resonator_bench.cxx $SRC -o ../.test/resonator_bench_scalar.exe
+
+cd ../.test
+./resonator_bench.exe "$@"
+./resonator_bench_scalar.exe "$@"
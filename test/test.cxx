@@ -1,217 +1,4 @@
-#include <fstream>
-#include <iostream>
-#include <cstring>
-#include <vector>
-#include <map>
-
-void write_wav(const std::vector<int16_t> &buffer, const std::string &fileName)
-{
-    typedef struct WAV_HEADER
-    {
-        /* RIFF Chunk Descriptor */
-        uint8_t RIFF[4] = {'R', 'I', 'F', 'F'}; // RIFF Header Magic header
-        uint32_t ChunkSize;                     // RIFF Chunk Size
-        uint8_t WAVE[4] = {'W', 'A', 'V', 'E'}; // WAVE Header
-        /* "fmt" sub-chunk */
-        uint8_t fmt[4] = {'f', 'm', 't', ' '}; // FMT header
-        uint32_t Subchunk1Size = 16;           // Size of the fmt chunk
-        uint16_t AudioFormat = 1;              // Audio format 1=PCM,6=mulaw,7=alaw,     257=IBM
-                                               // Mu-Law, 258=IBM A-Law, 259=ADPCM
-        uint16_t NumOfChan = 1;                // Number of channels 1=Mono 2=Sterio
-        uint32_t SamplesPerSec = 48000;        // Sampling Frequency in Hz
-        uint32_t bytesPerSec = 48000 * 2;      // bytes per second
-        uint16_t blockAlign = 2;               // 2=16-bit mono, 4=16-bit stereo
-        uint16_t bitsPerSample = 16;           // Number of bits per sample
-        /* "data" sub-chunk */
-        uint8_t Subchunk2ID[4] = {'d', 'a', 't', 'a'}; // "data"  string
-        uint32_t Subchunk2Size;                        // Sampled data length
-    } wav_hdr;
-
-    static_assert(sizeof(wav_hdr) == 44, "");
-
-    auto fsize = buffer.size() * sizeof(int16_t);
-    std::string in_name = "test.bin"; // raw pcm data without wave header
-
-    wav_hdr wav;
-    wav.ChunkSize = fsize + sizeof(wav_hdr) - 8;
-    wav.Subchunk2Size = fsize + sizeof(wav_hdr) - 44;
-
-    std::ofstream out(fileName, std::ios::binary);
-    out.write(reinterpret_cast<const char *>(&wav), sizeof(wav));
-    out.write(reinterpret_cast<const char *>(&buffer[0]), fsize);
-}
-
-#include "machine.h"
-#include "stmlib/dsp/dsp.h"
-
-uint32_t random(uint32_t howbig)
-{
-    if (howbig == 0)
-        return 0;
-    return std::rand() % howbig;
-}
-
-namespace gfx
-{
-    void drawPixel(uint8_t *buffer, int16_t x, int16_t y, uint8_t color) {}
-    void drawLine(uint8_t *buffer, int x1, int y1, int x2, int y2) {}
-    void drawRect(uint8_t *buffer, int x1, int y1, int w, int h) {}
-    void drawXbm(uint8_t *buffer, int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t *xbm) {}
-    void drawString(uint8_t *buffer, int16_t x, int16_t y, const char *text, uint8_t font) {}
-    void drawEngine(uint8_t *buffer, machine::Engine *engine) {}
-    void DrawKnob(unsigned char *, int, int, char const *, unsigned short, bool) {}
-}
-
-namespace machine
-{
-    bool MidiHandler::enabled() { return false; }
-
-    static struct : MidiHandler
-    {
-        void midiReceive(uint8_t midiByte) override {}
-        void midiReset() override {}
-    } _dummy;
-
-    MidiHandler *midi_handler = &_dummy;
-
-    uint32_t &get_bpm()
-    {
-        static uint32_t bpm = 120 * 100;
-        return bpm;
-    }
-
-    uint32_t digital_inputs; // millis()
-    float cv_voltage[4] = {};
-
-    template <>
-    float get_cv<float>(int src)
-    {
-        return cv_voltage[src];
-    }
-
-    int get_io_info(int type, int index, char *name)
-    {
-        return 0;
-    }
-
-    bool get_trigger(int src)
-    {
-        return digital_inputs & (1 << src);
-    }
-
-    float audio_in[2][FRAME_BUFFER_SIZE];
-
-    template <>
-    float *get_aux<float>(int src)
-    {
-        if (src == -1)
-        {
-            return audio_in[1];
-        }
-
-        if (src == -2)
-        {
-            return audio_in[2];
-        }
-
-        return nullptr;
-    }
-
-    float *tmp_buff()
-    {
-        static float __tmp[machine::FRAME_BUFFER_SIZE * 12];
-        static int __tmpP = 0;
-
-        __tmpP += machine::FRAME_BUFFER_SIZE;
-        __tmpP %= LEN_OF(__tmp);
-        return &__tmp[__tmpP];
-    }
-
-    template <typename T>
-    void _push(T *buff, size_t len, float f, OutputFrame *out)
-    {
-        auto tmp = tmp_buff();
-
-        if (out->out == nullptr)
-            out->out = tmp;
-        else if (out->aux == nullptr)
-            out->aux = tmp;
-
-        T *buff2 = buff;
-        for (size_t i = 0; i < len; i++)
-        {
-            for (size_t j = 0; j < (machine::FRAME_BUFFER_SIZE / len); j++)
-                *tmp++ = (float)*buff2 * f;
-
-            ++buff2;
-        }
-    }
-
-    template <>
-    void OutputFrame::push(float *buff, size_t len)
-    {
-        _push(buff, len, 1.f, this);
-    }
-
-    template <>
-    void OutputFrame::push(int16_t *buff, size_t len)
-    {
-        _push(buff, len, 5.f / INT16_MAX, this);
-    }
-
-    template <>
-    void OutputFrame::push(int32_t *buff, size_t len)
-    {
-        _push(buff, len, 1.f / machine::PITCH_PER_OCTAVE, this);
-    }
-
-    struct EngineDef
-    {
-        const char *engine;
-        std::function<Engine *()> init;
-    };
-
-    static std::vector<EngineDef> registry;
-
-    void add(const char *machine, const char *engine, std::function<Engine *()> createFunc)
-    {
-        registry.push_back({engine, createFunc});
-    }
-
-    void ModulationSource::display(uint8_t *buffer, int x, int y)
-    {
-    }
-
-    void add_modulation_source(const char *name, std::function<void(Parameter *)> createFunc)
-    {
-    }
-
-    void add_quantizer_scale(const char *name, const QuantizerScale &scale)
-    {
-    }
-
-    void *malloc(size_t size)
-    {
-        auto ptr = ::malloc(size);
-        memset(ptr, 0, size);
-        return ptr;
-    }
-
-    void free(machine::Engine *&ptr)
-    {
-        if (ptr != nullptr)
-        {
-            ptr->~Engine();
-            ::free(ptr);
-            ptr = nullptr;
-        }
-    }
-}
-
-#undef MACHINE_INIT
-#define MACHINE_INIT(init_fun) \
-    extern void init_fun();    \
-    init_fun();
+#include "host.hxx"
 
 #include "plaits/dsp/voice.h"
 
@@ -220,19 +7,7 @@ int main()
     auto f = plaits::NoteToFrequency(machine::DEFAULT_NOTE);
     printf("%f\n", f);
 
-    MACHINE_INIT(init_voltage);
-    MACHINE_INIT(init_peaks);
-    MACHINE_INIT(init_braids);
-    MACHINE_INIT(init_plaits);
-    MACHINE_INIT(init_sample_roms);
-    MACHINE_INIT(init_clap);
-    MACHINE_INIT(init_reverb);
-    MACHINE_INIT(init_faust);
-    MACHINE_INIT(init_rings);
-    MACHINE_INIT(init_speech);
-    MACHINE_INIT(init_sam);
-    MACHINE_INIT(init_delay);
-    MACHINE_INIT(init_modulations);
+    init_machines();
 
     // return;
 